@@ -7,31 +7,24 @@
 
 #include "Tonality.hpp"
 
+/**
+ * A major tonality. It is a view on the table of its key, which is shared by all the major tonalities with the same tonic
+ */
 class MajorTonality : public Tonality {
 protected:
-public:
     /**
-     * Constructor
+     * Get the table of a major key. The tables of the 12 major keys are built the first time this function is called
      * @param t the tonic of the tonality
+     * @return the table of the key
      */
-    explicit MajorTonality(int t);
-
-    /** Abstract methods from Tonality class */
-
-    /**
-     * Get the chord quality for each degree
-     * @param degree a degree of the scale [0,6]
-     * @return the default chord quality for the given degree
-     */
-    int get_chord_quality(int degree) override;
+    static const TonalityTable& table_of(int t);
 
+public:
     /**
-     * Get the chord notes for a given degree
-     * @param degree a degree of the scale [1,7]
-     * @return an IntSet containing the chord notes for the given degree
+     * Constructor
+     * @param t the tonic of the tonality
      */
-    IntSet get_scale_degree_chord(int degree) override;
+    explicit MajorTonality(int t);
 };
 
-
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,233 @@
+// Author: Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description: Classes allowing several search engines running in parallel threads to share information
+//
+#ifndef SHAREDSEARCH
+#define SHAREDSEARCH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "Utilities.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/**
+ * The best cost vector found so far by a group of search engines. It is shared by all the engines so that each one
+ * can prune with the bound found by the others. All the methods are thread safe.
+ */
+class SharedLexBound {
+protected:
+    mutable std::mutex  lock;                   // protects the bound
+    vector<int>         bestCosts;              // the best cost vector found so far
+    bool                found = false;          // true if a solution has been found
+
+public:
+    /**
+     * Updates the bound if the given cost vector is lexicographically smaller than the current one
+     * @param costs a cost vector in lexicographical order
+     * @return true if the bound was improved
+     */
+    bool update(const vector<int> &costs);
+
+    /**
+     * Returns the best cost vector found so far
+     * @param costs filled with the best cost vector found so far if there is one
+     * @return true if a solution has been found by one of the engines
+     */
+    bool get(vector<int> &costs) const;
+};
+
+/**
+ * An archive of the best distinct solutions found during a branch and bound search. It keeps at most a given number of
+ * solutions, ordered by their cost vector, all within the margin of the best one. Once it is full, the search only has
+ * to find solutions better than the worst archived one, so that a single search collects the best solutions instead of
+ * only the optimal one. All the methods are thread safe.
+ */
+class SolutionArchive {
+protected:
+    mutable std::mutex                      lock;           // protects the solutions
+    int                                     capacity;       // the maximum number of solutions kept
+    double                                  margin;         // the margin on the costs of the kept solutions
+    vector<pair<vector<int>, vector<int>>>  solutions;      // (costs, voicing) pairs, sorted by costs
+
+public:
+    /**
+     * Constructor
+     * @param capacity the maximum number of solutions kept
+     * @param margin the percentage of deviation from the costs of the best solution allowed for the other solutions
+     */
+    SolutionArchive(int capacity, double margin);
+
+    /**
+     * Returns whether a cost vector is within a margin of a reference cost vector. Each cost must be within the margin
+     * of the reference cost, and the last cost, which is negative, must not be more than the margin worse.
+     * @param costs a cost vector
+     * @param reference the reference cost vector
+     * @param margin the percentage of deviation allowed
+     * @return true if the costs are within the margin of the reference
+     */
+    static bool within_margin(const vector<int> &costs, const vector<int> &reference, double margin);
+
+    /**
+     * Adds a solution if it is not already in the archive and is within the margin of the best solution. A new best
+     * solution removes the archived solutions that are no longer within its margin, and the worst solution is removed
+     * if the archive is full
+     * @param costs the cost vector of the solution
+     * @param voicing the notes of the solution
+     * @param removed if not nullptr, filled with the voicings of the solutions removed from the archive
+     * @return true if the solution is kept
+     */
+    bool add(const vector<int> &costs, const vector<int> &voicing, vector<vector<int>>* removed = nullptr);
+
+    /**
+     * Returns the cost vector that a new solution has to improve on
+     * @param costs filled with the cost vector of the worst archived solution if the archive is full
+     * @return true if the archive is full
+     */
+    bool worst(vector<int> &costs) const;
+
+    /**
+     * Returns the cost vector of the best archived solution
+     * @param costs filled with the cost vector of the best solution if there is one
+     * @return true if the archive is not empty
+     */
+    bool best(vector<int> &costs) const;
+
+    /**
+     * Returns the maximum value of the first cost for a solution to be within the margin of a better solution
+     * @param bound filled with the bound if the archive is not empty
+     * @return true if the archive is not empty
+     */
+    bool first_cost_bound(int &bound) const;
+
+    /**
+     * Returns the archived solutions, which are all within the margin of the best one
+     * @return (costs, voicing) pairs, best first
+     */
+    vector<pair<vector<int>, vector<int>>> get_solutions() const;
+};
+
+/**
+ * A stop object shared by several search engines. The engines stop when the time limit is reached or when one of them
+ * asked to stop all the others, for example because it proved that its solution is optimal.
+ */
+class SharedStop : public Search::Stop {
+protected:
+    std::atomic<bool>   stopRequested;          // true if the engines must stop
+    Search::TimeStop    timeStop;               // the time limit
+
+public:
+    /**
+     * Constructor
+     * @param timeLimit the time limit in milliseconds
+     */
+    explicit SharedStop(double timeLimit);
+
+    /**
+     * Asks all the engines using this object to stop
+     */
+    void request_stop();
+
+    /**
+     * Returns whether the search must stop
+     * @param s the statistics of the engine
+     * @param o the options of the engine
+     * @return true if the time limit is reached or if a stop was requested
+     */
+    bool stop(const Search::Statistics &s, const Search::Options &o) override;
+};
+
+/**
+ * A token through which another thread can cancel, pause and resume a running search. A cancelled search returns the
+ * best solution found so far. A paused search blocks its thread inside the stop object of its engine (see
+ * CancellableStop) without using the processor until it is resumed or cancelled, and then goes on with its incumbent
+ * solution and its search tree intact. All the methods are thread safe.
+ */
+class CancellationToken {
+protected:
+    std::atomic<bool>       cancelled;          // true once the search is cancelled
+    std::atomic<bool>       paused;             // true while the search is paused
+    std::mutex              lock;               // protects the waits on the state
+    std::condition_variable changed;            // notified when the search is resumed or cancelled
+
+public:
+    CancellationToken();
+
+    /**
+     * Cancels the search. A cancelled search cannot be resumed
+     */
+    void cancel();
+
+    /**
+     * Pauses the search. It stops at the next node and waits until it is resumed
+     */
+    void pause();
+
+    /**
+     * Resumes a paused search
+     */
+    void resume();
+
+    /**
+     * Returns whether the search is cancelled
+     * @return true if the search is cancelled
+     */
+    bool is_cancelled() const;
+
+    /**
+     * Returns whether the search is paused
+     * @return true if the search is paused
+     */
+    bool is_paused() const;
+
+    /**
+     * Blocks the calling thread while the search is paused
+     * @return true if the search can go on, false if it was cancelled
+     */
+    bool wait_while_paused();
+};
+
+/**
+ * A stop object that stops the search when its time limit is reached or when its token is cancelled. When its token is
+ * paused, it blocks the thread of the engine inside stop until the token is resumed, so that the engine never sees a
+ * stop and goes on with its search tree intact. The time spent in pause does not count in the time limit.
+ */
+class CancellableStop : public Search::Stop {
+protected:
+    CancellationToken*                                      token;          // the token of the search, may be nullptr
+    double                                                  timeLimit;      // the time limit in milliseconds
+    double                                                  used;           // the time used before the last pause
+    std::chrono::high_resolution_clock::time_point          since;          // the time the search was last resumed
+
+public:
+    /**
+     * Constructor
+     * @param timeLimit the time limit in milliseconds
+     * @param token the token of the search, nullptr if the search can only be stopped by the time limit
+     */
+    CancellableStop(double timeLimit, CancellationToken* token);
+
+    /**
+     * Stops the clock while the search is paused
+     */
+    void suspend();
+
+    /**
+     * Restarts the clock when the search is resumed
+     */
+    void resume();
+
+    /**
+     * Returns whether the search must stop. If the token is paused, blocks until it is resumed or cancelled
+     * @param s the statistics of the engine
+     * @param o the options of the engine
+     * @return true if the time limit is reached or if the token is cancelled
+     */
+    bool stop(const Search::Statistics &s, const Search::Options &o) override;
+};
+
+#endif
@@ -5,43 +5,67 @@
 #ifndef TONALITY
 #define TONALITY
 
+#include <array>
+
 #include "Utilities.hpp"
 
+/** The number of degrees on which chords are built, including the chromatic ones (see the degrees enum) */
+const int N_OF_DEGREES = AUGMENTED_SIXTH + 1;
+
 /**
- * This class is an abstract class modeling a tonality
+ * The precomputed data of a key. The tables of the 12 major and the 12 minor keys are built once, the first time a key
+ * of their mode is used, and are never modified afterwards, so any number of threads can read them at the same time.
+ */
+struct TonalityTable {
+    string                          name;               // name of the tonality
+    int                             tonic;              // tonic of the tonality [0,11]
+    int                             mode;               // mode of the tonality
+    const vector<int>*              scale;              // scale of the tonality
+    array<int, N_OF_DEGREES>        degreesNotes;       // notes [0,11] on which the chords of each degree are built
+    array<int, N_OF_DEGREES>        chordQualities;     // default chord quality of each degree
+    array<IntSet, N_OF_DEGREES>     scaleDegrees;       // all the notes [0,127] of each degree
+    array<IntSet, N_OF_DEGREES>     scaleDegreesChords; // all the notes [0,127] of the default chord of each degree
+    set<int>                        tonalNotes;         // notes that don't change in major or minor mode (1,4,5 degrees)
+    set<int>                        modalNotes;         // notes that change in major or minor mode (3,6,7 degrees)
+};
+
+/**
+ * This class is an abstract class modeling a tonality. It is a read-only view on the precomputed table of a key: all
+ * its methods are const and return references to the table, so a Tonality can be shared by several threads.
  * @todo develop this comment section once the class is finished
  */
 class Tonality { // abstract class
 protected:
-    string name;                            // name of the tonality
-    int tonic;                              // tonic of the tonality
-    int mode;                               // mode of the tonality
-    vector<int> scale;                      // scale of the tonality
-
-    map<int, int> chord_qualities;          // map of [degree, chord_quality] for each degree of the scale (0 to 6) (set by child classes)
-    map<int, int> degrees_notes;            // notes corresponding to the degrees of the scale on which the chords are based
+    const TonalityTable*    table;                  // the precomputed data of the key
 
-    map<int, IntSet> scale_degrees;         // map of [degree, all_notes] for each degree of the scale (0 to 6). May contain multiple notes per degree depending on the mode
-    set<int> tonal_notes;                   // notes that don't change in major or minor mode (1,4,5 degrees)
-    set<int> modal_notes;                   // notes that change in major or minor mode (3,6,7 degrees)
-
-    map<int, IntSet> scale_degrees_chords;  // map of [degree, chord] for each degree of the scale (0 to 6) (set by child classes)
-
-public:
     /**
      * Constructor
-     * Creates a tonality object based on the tonality (tonic, mode and scale)
+     * Creates a view on the table of a key. Only the child classes, which own the tables of their mode, can call it
+     * @param t the table of the key
+     */
+    explicit Tonality(const TonalityTable &t);
+
+    /**
+     * Computes the table of a key
      * @param t the tonic of the tonality
      * @param m the mode of the tonality
      * @param s the scale of the tonality
+     * @param qualities the default chord quality of each degree
+     * @return the table of the key
+     */
+    static TonalityTable build_table(int t, int m, const vector<int> &s, const array<int, N_OF_DEGREES> &qualities);
+
+public:
+    /**
+     * Destructor
      */
-    Tonality(int t, int m, vector<int> s);
+    virtual ~Tonality() = default;
 
     /**
      * Get the name of the tonality
      * @return a string containing the name of the tonality
      */
-    string get_name() const;
+    const string& get_name() const;
 
     /**
      * Get the tonic of the tonality
@@ -59,68 +83,66 @@ public:
      * Get the scale of the tonality
      * @return the scale of the tonality
      */
-    vector<int> get_scale();
+    const vector<int>& get_scale() const;
 
     /**
      * Get the notes corresponding to the degrees of the scale on which chords are built
-     * @return a map containing the notes for each of the scale degrees
+     * @return the notes for each of the degrees
      */
-    map<int,int> get_degrees_notes();
+    const array<int, N_OF_DEGREES>& get_degrees_notes() const;
 
     /**
      * Get the note on which the chord is built for a given degree
-     * @param degree the degree of the scale [0,6]
+     * @param degree a degree [0,15] (see the degrees enum)
      * @return the note for the given degree
      */
-    int get_degree_note(int degree);
+    int get_degree_note(int degree) const;
 
     /**
      * Get all the notes for each scale degree
-     * @return a map of [degree, all_notes] for each degree of the scale (0 to 6)
+     * @return the notes [0,127] of each degree
      */
-    map<int, IntSet> get_scale_degrees();
+    const array<IntSet, N_OF_DEGREES>& get_scale_degrees() const;
 
     /**
      * Get all the notes for a given scale degree
-     * @param degree a degree of the scale [0,6]
+     * @param degree a degree [0,15] (see the degrees enum)
      * @return an IntSet containing all the notes for the given scale degree
      */
-    IntSet get_scale_degree(int degree);
+    const IntSet& get_scale_degree(int degree) const;
 
     /**
      * Get the notes that don't change in major or minor mode (1,4,5 degrees)
-     * @return an IntSet containing the tonal notes
+     * @return the tonal notes
      */
-    set<int> get_tonal_notes();
+    const set<int>& get_tonal_notes() const;
 
     /**
      * Get the notes that change in major or minor mode (3,6,7 degrees)
-     * @return an IntSet containing the modal notes
-     */
-    set<int> get_modal_notes();
-
-    /**
-     * @return a string representing a tonality
+     * @return the modal notes
      */
-    string to_string();
-
-    string pretty();
-
-    /** ABSTRACT METHODS */
+    const set<int>& get_modal_notes() const;
 
     /**
      * Get the chord quality for each degree
-     * @param degree a degree of the scale [0,6]
+     * @param degree a degree [0,15] (see the degrees enum)
      * @return the default chord quality for the given degree
      */
-    virtual int get_chord_quality(int degree) = 0;
+    int get_chord_quality(int degree) const;
 
     /**
      * Get the chord notes for a given degree
-     * @param degree a degree of the scale [0,6]
-     * @return an IntSet containing the chord notes for the given degree
+     * @param degree a degree [0,15] (see the degrees enum)
+     * @return an IntSet containing the notes [0,127] of the default chord of the given degree
      */
-    virtual IntSet get_scale_degree_chord(int degree) = 0;
+    const IntSet& get_scale_degree_chord(int degree) const;
+
+    /**
+     * @return a string representing a tonality
+     */
+    string to_string() const;
+
+    string pretty() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -40,57 +40,87 @@ enum solver_types{
     LDS_SOLVER  //2
 };
 
+/** Engines that can solve a FourVoiceTexture problem */
+enum solving_engines{
+    GECODE_ENGINE,                  //0 restart based branch and bound on the constraint model
+    DYNAMIC_PROGRAMMING_ENGINE,     //1 exact dynamic programming over the legal voicings of each chord
+    PARALLEL_ENGINE,                //2 restart based branch and bound using all the cores
+    DETERMINISTIC_PARALLEL_ENGINE,  //3 independent subproblems solved on all the cores, reproducible results
+    LNS_ENGINE                      //4 large neighbourhood search, then a complete search starting from its solution
+};
+
+/** The time given to the large neighbourhood search before the complete search of LNS_ENGINE, in milliseconds */
+const double LNS_PHASE_TIME_LIMIT = 5000;
+
+/** Positions of the costs in the cost vector of a FourVoiceTexture, minimized in lexicographical order */
+enum cost_vector_indices{
+    INCOMPLETE_CHORDS_COST,                 //0 the number of chords missing a note
+    DIMINISHED_CHORDS_WITH_4_NOTES_COST,    //1 the number of fundamental state diminished chords with 4 notes
+    CHORDS_WITH_LESS_THAN_4_VALUES_COST,    //2 the number of chords with less than 4 different values
+    MELODIC_INTERVALS_COST,                 //3 the cost of the melodic intervals, bounded by MelodicCostBound
+    COMMON_NOTES_COST                       //4 minus the number of common notes kept in the same voice
+};
+
 /** Branching strategies */
 enum variable_selection{
     DEGREE_MAX,                     //0
     DOM_SIZE_MIN,                   //1
     RIGHT_TO_LEFT,                  //2
     LEFT_TO_RIGHT_SOPRANO_TO_BASS,  //3
-    AFC_MAX,                        //4
-};
-
-/// go <-- soprano->bass: 4-3-2-1-8-7-6-5 etc
-auto right_to_left = [](const Space& home, const IntVar& x, int i) {
-    return i;
+    AFC_MAX,                        //4 the variables whose propagators failed most often (accumulated failure count)
+    ACTION_MAX,                     //5 the variables whose domains were pruned most often
+    CHB_MAX,                        //6 the variables pruned the most recently before a failure (conflict history)
 };
 
-/// go --> soprano->bass
-auto left_to_right_soprano_to_bass = [](const Space& home, const IntVar& x, int i) {
-    return (i/4) * 4 + (4 - i%4);
-};
+/** The number of variable selection heuristics (see the variable_selection enum) */
+const int N_OF_VARIABLE_SELECTIONS = CHB_MAX + 1;
 
-const vector<IntVarBranch> variable_selection_heuristics = {INT_VAR_DEGREE_MAX(),
-                                                            INT_VAR_SIZE_MIN(),
-                                                            INT_VAR_MERIT_MAX(right_to_left),
-                                                            INT_VAR_MERIT_MIN(left_to_right_soprano_to_bass)};
+/// names of the variable selection heuristics, indexed by the variable_selection enum
+const vector<string> variable_selection_heuristics_names = {"Degree max", "Domain size min", "Right to left",
+                                                            "Left to right soprano to bass", "AFC max", "Action max",
+                                                            "CHB max"};
 
-const vector<string> variable_selection_heuristics_names = {"Degree max", "Domain size min", "Left to right",
-                                                            "Right to left", "AFC max"};
+/**
+ * Returns the variable selection of a heuristic. The static orders only depend on the variables, while the learned
+ * heuristics (AFC, action and CHB) gather statistics on the failures during search, which the restarts keep. A new
+ * branching is returned each time, so the statistics are not shared between problems.
+ * @param heuristic a variable selection heuristic (see the variable_selection enum)
+ * @param decay the decay factor in ]0,1] by which the AFC and the action of all the variables are multiplied at each
+ * failure, 1 to keep the whole history. CHB has no decay factor: its step size decreases with the number of failures
+ * @return the variable selection of the heuristic
+ */
+IntVarBranch variable_selection_heuristic(int heuristic, double decay = 1.0);
 
 enum value_selection{
-    VAL_MIN,            //0
-    VAL_MAX,            //1
-    VAL_MED,            //2
-    VAL_RND,            //3
+    VAL_MIN,                //0
+    VAL_MAX,                //1
+    VAL_MED,                //2
+    VAL_RND,                //3
+    VAL_CLOSEST_NEIGHBOUR,  //4 the cheapest melodic intervals to the same voice in the neighbouring chords, ties at random
 };
 
-/// value selection heuristic
-auto branchVal = [](const Space& home, IntVar x, int i) {
-    return x.min();
+/// neighbourhoods of the large neighbourhood search
+enum lns_neighbourhoods{
+    LNS_RANDOM_WINDOW,      //0 a window of chords chosen uniformly
+    LNS_COST_GUIDED_WINDOW, //1 a window centered on a chord chosen proportionally to its cost in the incumbent
+    LNS_MIXED_WINDOW        //2 random and cost guided windows alternately
 };
 
-/// commit function (EQ and DIFF)
-auto branchCommit = [](Space& home, unsigned int a, IntVar x, int i, int n){
-    if (a == 0U){
-        rel(home, x, IRT_EQ, n);
-    } else {
-        rel(home, x, IRT_NQ, n);
-    }
-};
+/** The number of value selection heuristics (see the value_selection enum) */
+const int N_OF_VALUE_SELECTIONS = VAL_CLOSEST_NEIGHBOUR + 1;
 
-const vector<IntValBranch> value_selection_heuristics = {INT_VAL_MIN(), INT_VAL_MAX(), INT_VAL_MED(), INT_VAL_RND(1U)};
+/// names of the value selection heuristics, indexed by the value_selection enum
+const vector<string> value_selection_heuristics_names = {"Value min", "Value max", "Median value", "Value random",
+                                                         "Closest neighbour"};
 
-const vector<string> value_selection_heuristics_names = {"Value min", "Value max", "Median value", "Value random"};
+/**
+ * Returns the value selection of a heuristic. VAL_CLOSEST_NEIGHBOUR depends on the other notes of the space, so
+ * FourVoiceTexture builds it and it is not returned by this function.
+ * @param heuristic a value selection heuristic (see the value_selection enum) other than VAL_CLOSEST_NEIGHBOUR
+ * @param seed the seed of the random value selection
+ * @return the value selection of the heuristic
+ */
+IntValBranch value_selection_heuristic(int heuristic, unsigned int seed = 1U);
 
 
 /** Voice ranges */
@@ -116,6 +146,21 @@ const int OCTAVE_COST = 6;
 
 const int MAX_MELODIC_COST = SEVENTH_COST;
 
+/// cost of each melodic interval in [-PERFECT_OCTAVE, PERFECT_OCTAVE], indexed by interval + PERFECT_OCTAVE
+const vector<int> MELODIC_INTERVAL_COSTS = {
+///     -octave,     - major seventh,    - minor seventh,    - major sixth,  - minor sixth,
+        OCTAVE_COST, SEVENTH_COST,       SEVENTH_COST,       SIXTH_COST,     SIXTH_COST,
+///     -perfect fifth,     - tritone,      -perfect fourth,    - major third,  - minor third,
+        FIFTH_COST,         TRITONE_COST,   FOURTH_COST,        THIRD_COST,     THIRD_COST,
+///     - major second,     - minor second,     unison,
+        SECOND_COST,        SECOND_COST,        UNISON_COST,
+///     minor second,   major second,   minor third,    major third,    perfect fourth,
+        SECOND_COST,    SECOND_COST,    THIRD_COST,     THIRD_COST,     FOURTH_COST,
+///     tritone,        perfect fifth,  minor sixth,    major sixth,    minor seventh,
+        TRITONE_COST,   FIFTH_COST,     SIXTH_COST,     SIXTH_COST,     SEVENTH_COST,
+///     major seventh,  octave
+        SEVENTH_COST,   OCTAVE_COST};
+
 /** Notes */
 const int B_SHARP = 0;
 const int C = 0;
@@ -261,6 +306,9 @@ const map<int, vector<int>> chordQualitiesIntervals = {
         {MINOR_NINTH_DOMINANT_CHORD,   MINOR_NINTH_DOMINANT_CHORD_INTERVALS}
 };
 
+/** The number of chord qualities (see the chordTypes enum) */
+const int N_OF_CHORD_QUALITIES = MINOR_NINTH_DOMINANT_CHORD + 1;
+
 // Chord states
 enum chordStates{
     FUNDAMENTAL_STATE,  //0
@@ -328,6 +376,23 @@ vector<int> get_all_notes_in_chord(int root, int quality);
  */
 vector<int> get_all_given_note(int note);
 
+/**
+ * Get all the notes [0,127] of a chord as an IntSet. The sets of the 12 roots and all the qualities are built once, the
+ * first time one of them is needed, and are shared read-only by all the models afterwards
+ * @param root the root of the chord
+ * @param quality the quality of the chord
+ * @return an IntSet containing the same notes as get_all_notes_in_chord
+ */
+const IntSet& get_all_notes_in_chord_set(int root, int quality);
+
+/**
+ * Get all the notes [0,127] of a pitch class as an IntSet. The sets of the 12 pitch classes are built once, the first
+ * time one of them is needed, and are shared read-only by all the models afterwards
+ * @param note a note
+ * @return an IntSet containing the same notes as get_all_given_note
+ */
+const IntSet& get_all_given_note_set(int note);
+
 /**
  * Get the interval in semitones between the root and
  * @param quality the quality of the chord
@@ -389,6 +454,13 @@ vector<int> intVarArray_to_int_vector(IntVarArray vars);
  */
 string intVarArgs_to_string(IntVarArgs args);
 
+/**
+ * Returns the values of an IntVarArgs as a vector of integers
+ * @param args an IntVarArgs whose variables are all assigned
+ * @return a vector containing the values of the variables
+ */
+vector<int> intVarArgs_to_int_vector(IntVarArgs args);
+
 /**
  * Returns the name of a note based on its MIDI value
  * @param note an integer
@@ -0,0 +1,93 @@
+// Author: Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description: A thread pool in which idle threads steal the tasks queued by the other threads
+//
+#ifndef WORKSTEALINGPOOL
+#define WORKSTEALINGPOOL
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A fixed size thread pool. Each thread has its own queue of tasks: it takes the most recent task of its queue, and
+ * when its queue is empty it steals the oldest task of another queue. Tasks submitted from outside the pool are
+ * distributed over the queues in round robin, tasks submitted by a task go to the queue of the thread running it.
+ */
+class WorkStealingPool {
+protected:
+    /**
+     * The queue of tasks of a thread
+     */
+    struct TaskQueue {
+        std::mutex                      lock;           // protects the tasks
+        deque<function<void()>>         tasks;          // the tasks waiting to be executed
+    };
+
+    vector<unique_ptr<TaskQueue>>       queues;         // one queue per thread
+    vector<std::thread>                 workers;        // the threads of the pool
+    std::atomic<int>                    nOfQueued;      // the number of tasks in the queues
+    std::atomic<unsigned int>           nextQueue;      // the queue receiving the next task submitted from outside
+
+    std::mutex                          idleLock;       // used to wait for new tasks
+    std::condition_variable             idle;           // notified when a task is submitted or the pool is destroyed
+    bool                                stopping;       // true when the pool is destroyed
+
+    std::mutex                          doneLock;       // protects nOfUnfinished and error
+    std::condition_variable             done;           // notified when all the tasks are finished
+    int                                 nOfUnfinished;  // the number of tasks submitted and not finished yet
+    exception_ptr                       error;          // the first exception thrown by a task
+
+    /**
+     * Takes a task from the queue of a thread, or steals one from the other queues
+     * @param id the index of the thread
+     * @param task filled with the task
+     * @return true if a task was found
+     */
+    bool take_task(int id, function<void()> &task);
+
+    /**
+     * The loop executed by each thread of the pool
+     * @param id the index of the thread
+     */
+    void run(int id);
+
+public:
+    /**
+     * Constructor
+     * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+     */
+    explicit WorkStealingPool(int nOfThreads = 0);
+
+    /**
+     * Destructor. Waits for the threads to finish their current task, the tasks left in the queues are not executed
+     */
+    ~WorkStealingPool();
+
+    /**
+     * Returns the number of threads of the pool
+     * @return the number of threads
+     */
+    int get_size() const;
+
+    /**
+     * Adds a task to the pool
+     * @param task the task to execute
+     */
+    void submit(function<void()> task);
+
+    /**
+     * Waits until all the submitted tasks are finished. If a task has thrown an exception, it is rethrown here
+     */
+    void wait();
+};
+
+#endif
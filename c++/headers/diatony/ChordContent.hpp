@@ -0,0 +1,134 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator linking the notes of a chord to their doubling and to the number of different notes
+//
+#ifndef CHORDCONTENT_HPP
+#define CHORDCONTENT_HPP
+
+#include <array>
+
+#include "../aux/Utilities.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/**
+ * Bounds on the number of times each note (regardless of its octave) is present in a chord. The chord_note_occurrence
+ * functions restrain them with the doubling rules that only depend on the chord, and they are then enforced either by
+ * the ChordContent propagator or by count constraints.
+ */
+struct ChordOccurrences {
+    array<int, PERFECT_OCTAVE>  min;        // the minimum number of occurrences of each note [0,11]
+    array<int, PERFECT_OCTAVE>  max;        // the maximum number of occurrences of each note [0,11]
+
+    /**
+     * Constructor
+     * @param nOfVoices the number of voices, which bounds the number of occurrences of every note
+     */
+    explicit ChordOccurrences(int nOfVoices);
+
+    /**
+     * Restrains the number of occurrences of a note, as count(home, chord, note, relation, n) would
+     * @param note a note [0,11]
+     * @param relation the relation between the number of occurrences and n (IRT_EQ, IRT_LQ, IRT_LE, IRT_GQ or IRT_GR)
+     * @param n the number of occurrences
+     */
+    void restrain(int note, IntRelType relation, int n);
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                 ChordContent class                                                  *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This propagator states in one place what the model used to state per chord with two nvalues constraints and a count
+ * constraint for each note of the chord: the number of different values of the notes, the number of different notes
+ * regardless of their octave, and the bounds on the occurrences of each note. Since a chord only has a few notes, it
+ * enumerates the voicings left in the domains, keeping the occupied notes in a 12 bit mask and the occurrences of each
+ * note along the way, and removes every value that belongs to no voicing respecting all three at once. The voicings
+ * are enumerated in increasing order, as restrain_voices_domains orders the voices of each chord.
+ */
+class ChordContent : public NaryPropagator<Int::IntView, Int::PC_INT_DOM> {
+protected:
+    using NaryPropagator<Int::IntView, Int::PC_INT_DOM>::x;   // [bass, tenor, alto, soprano, nOfValues, nOfNotes]
+    int                         nOfVoices;                  // the number of voices
+    ChordOccurrences            occurrences;                // the bounds on the occurrences of each note
+
+    /**
+     * Constructor for posting
+     * @param home the space
+     * @param views the notes of the chord followed by the number of different values and of different notes
+     * @param voices the number of voices
+     * @param occ the bounds on the occurrences of each note
+     */
+    ChordContent(Home home, ViewArray<Int::IntView> &views, int voices, const ChordOccurrences &occ);
+
+    /**
+     * Constructor for cloning
+     * @param home the space
+     * @param p the propagator to copy
+     */
+    ChordContent(Space &home, ChordContent &p);
+
+    /**
+     * Enumerates the voicings whose first notes are given and marks the values they use as supported
+     * @param voice the voice to assign next
+     * @param values the values left in the domains of the voices, one voice after the other
+     * @param first the index in values of the first value of each voice, followed by the number of values
+     * @param voicing the index in values of the notes of the voices below voice
+     * @param counts the number of occurrences of each note in voicing
+     * @param supported filled with whether each value in values belongs to a valid voicing, followed by the same for
+     * the numbers of different values and of different notes
+     */
+    void support(int voice, const int* values, const int* first, int* voicing, array<int, PERFECT_OCTAVE> &counts,
+                 bool* supported) const;
+
+public:
+    /**
+     * Posts the propagator
+     * @param home the space
+     * @param views the notes of the chord followed by the number of different values and of different notes
+     * @param voices the number of voices
+     * @param occ the bounds on the occurrences of each note
+     * @return ES_OK
+     */
+    static ExecStatus post(Home home, ViewArray<Int::IntView> &views, int voices, const ChordOccurrences &occ);
+
+    /**
+     * Copies the propagator during cloning
+     * @param home the space
+     * @return a copy of the propagator
+     */
+    virtual Propagator* copy(Space &home);
+
+    /**
+     * Returns the cost of the propagator: the enumeration is exponential in the number of voices, which is small
+     * @param home the space
+     * @param med the modification events
+     * @return the cost of the propagator
+     */
+    virtual PropCost cost(const Space &home, const ModEventDelta &med) const;
+
+    /**
+     * Removes the values that belong to no valid voicing of the chord
+     * @param home the space
+     * @param med the modification events
+     * @return the status of the propagation
+     */
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &med);
+};
+
+/**
+ * Links the notes of a chord to the number of different values and of different notes (regardless of their octave) in
+ * the chord, and enforces the bounds on the occurrences of each note, with a single ChordContent propagator
+ * @param home the instance of the problem
+ * @param currentChord the notes of the chord in the form [bass, tenor, alto, soprano]
+ * @param occurrences the bounds on the occurrences of each note
+ * @param nOfValues the number of different values in the chord
+ * @param nOfNotes the number of different notes in the chord
+ */
+void chord_content(Home home, const IntVarArgs &currentChord, const ChordOccurrences &occurrences,
+                   const IntVar &nOfValues, const IntVar &nOfNotes);
+
+#endif
@@ -5,19 +5,62 @@
 #ifndef space_wrapper_hpp
 #define space_wrapper_hpp
 
+#include <memory>
+
 #include "../aux/Utilities.hpp"
 #include "../aux/Tonality.hpp"
 #include "../aux/MajorTonality.hpp"
 #include "../aux/MinorTonality.hpp"
+#include "../aux/SharedSearch.hpp"
 #include "GeneralConstraints.hpp"
 #include "HarmonicConstraints.hpp"
 #include "VoiceLeadingConstraints.hpp"
+#include "ParallelIntervals.hpp"
+#include "MelodicCostBound.hpp"
+#include "ChordContent.hpp"
+#include "VoicingRules.hpp"
 #include "Preferences.hpp"
 
 using namespace Gecode;
 using namespace Gecode::Search;
 using namespace std;
 
+/** The version of the rules of the model. Increase it when a rule or a cost changes, so that the solutions stored for
+ * the former rules are no longer taken as optimal */
+const int MODEL_VERSION = 1;
+
+/**
+ * Search related options of a FourVoiceTexture instance. The default values give the branching used so far.
+ */
+struct FourVoiceTextureOptions {
+    int                         variableSelection = RIGHT_TO_LEFT;          // variable_selection heuristic
+    double                      decay = 1.0;                                // decay of the AFC and action heuristics
+    int                         valueSelection = VAL_RND;                   // value_selection heuristic
+    unsigned int                seed = 1U;                                  // seed of the random value selection
+    SharedLexBound*             sharedBound = nullptr;                      // bound shared with other engines, if any
+    int                         lnsWindow = 0;                              // chords relaxed at each restart, 0 disables LNS
+    int                         lnsNeighbourhood = LNS_MIXED_WINDOW;        // index in lns_neighbourhoods
+    vector<int>                 hint;                                       // a voicing to try first (warm start), or empty
+    SolutionArchive*            archive = nullptr;                          // collects near optimal solutions, if any
+    bool                        decomposedParallels = false;                // forbid parallels with reified constraints
+    bool                        melodicCostBound = true;                    // bound the melodic cost with shortest paths
+    bool                        decomposedChordContent = false;             // count notes with nvalues and count constraints
+    bool                        transitionTables = false;                   // post the rules between chords as tables
+    bool                        voicingIndices = false;                     // branch on one voicing index per chord
+};
+
+/**
+ * The parameters of a four voice texture problem. They never change during search, so all the copies of a space share
+ * the same descriptor and a copy only increments its reference count.
+ */
+struct ProblemDescriptor {
+    Tonality*                   tonality;                                   // The tonality of the piece
+    vector<int>                 chordDegrees;                               // The degrees of the chords
+    vector<int>                 chordQualities;                             // The qualities of the chords
+    vector<int>                 chordStates;                                // The states of the chords
+    IntArgs                     nOfNotesInChord;                            // The max number of notes in each chord
+};
+
 /***********************************************************************************************************************
  *                                                                                                                     *
  *                                                FourVoiceTexture class                                               *
@@ -35,32 +78,32 @@ protected:
 
     int                         nOfVoices = 4;                              // The number of voices
     int                         size;                                       // The number of chords
-    Tonality*                   tonality;                                   // The tonality of the piece
-    vector<int>                 chordDegrees;                               // The degrees of the chords
-    vector<int>                 chordQualities;                             // The qualities of the chords
-    vector<int>                 chordStates;                                // The states of the chords
-    IntArgs                     nOfNotesInChord;                            // The max number of notes in each chord
+    shared_ptr<const ProblemDescriptor> problem;                            // Shared by all the copies of the space
 
     /** ----------------------------------Problem variables--------------------------------------------------------- **/
 
     ///global array for all the notes for all voices
     IntVarArray                 fullChordsVoicing;
 
-    /// Melodic intervals
-    IntVarArray                 bassMelodicIntervals;
-    IntVarArray                 tenorMelodicIntervals;
-    IntVarArray                 altoMelodicIntervals;
-    IntVarArray                 sopranoMelodicIntervals;
-
+    /// Melodic intervals of all voices: [bass0, tenor0, alto0, soprano0, bass1, ...]. The intervals of a voice are
+    /// the slice starting at the voice with a step of nOfVoices
     IntVarArray                 allMelodicIntervals;
 
-    /// Harmonic intervals (always positive)
-    IntVarArray                 bassTenorHarmonicIntervals;
-    IntVarArray                 bassAltoHarmonicIntervals;
-    IntVarArray                 bassSopranoHarmonicIntervals;
-    IntVarArray                 tenorAltoHarmonicIntervals;
-    IntVarArray                 tenorSopranoHarmonicIntervals;
-    IntVarArray                 altoSopranoHarmonicIntervals;
+    /// Harmonic intervals between adjacent voices (always positive): [bassTenor0, tenorAlto0, altoSoprano0, bassTenor1,
+    /// ...]. The intervals of a pair are the slice starting at its lower voice with a step of nOfVoices - 1
+    IntVarArray                 harmonicIntervals;
+
+    /// Pitch classes [0,11] of the notes, in the same order as fullChordsVoicing. The rules on notes regardless of their
+    /// octave are all stated on these variables
+    IntVarArray                 pitchClasses;
+
+    /// Classes [0,11] of the harmonic intervals between adjacent voices, in the same order as harmonicIntervals. Only the
+    /// decomposed parallel intervals use them, so the array is empty when the ParallelIntervals propagator is used
+    IntVarArray                 harmonicIntervalClasses;
+
+    /// Index of the voicing of each chord in its legal voicings (see VoicingRules::legal_packed_voicings). The notes are
+    /// channelled to it and the search branches on it, so the array is empty unless the voicing index model is used
+    IntVarArray                 voicingIndices;
 
     /// cost variables auxiliary arrays
     IntVarArray                 nDifferentValuesInDiminishedChord;
@@ -81,8 +124,65 @@ protected:
 
     IntVarArgs                  costVector;                                 // the costs in lexicographical order for minimization
 
+    /// search
+    SharedLexBound*             sharedBound;                                // best costs found by other engines (or nullptr)
+    int                         lnsWindow;                                  // chords relaxed at each restart (0 if no LNS)
+    int                         lnsNeighbourhood;                           // how the relaxed window is chosen
+    Rnd                         lnsRnd;                                     // random generator of the neighbourhoods
+    SolutionArchive*            archive;                                    // near optimal solutions found (or nullptr)
+
     /** ---------------------------------------------Methods-------------------------------------------------------- **/
 
+    /**
+     * Constrains the cost vector to be lexicographically smaller than the best one found by the other engines sharing
+     * the bound. Does nothing if the bound is not shared or if no solution was found yet.
+     */
+    void post_shared_bound();
+
+    /**
+     * Constrains the cost vector to be lexicographically smaller than the worst solution of the archive once it is
+     * full, and the first cost to be within the margin of the best archived solution
+     */
+    void post_archive_bound();
+
+    /**
+     * Chooses the first chord of the window relaxed by the large neighbourhood search
+     * @param incumbent the best solution found so far
+     * @param restart the number of the restart, used to alternate the neighbourhoods
+     * @return the index of the first chord of the window
+     */
+    int lns_window_start(const FourVoiceTexture &incumbent, unsigned long int restart);
+
+    /**
+     * Returns the melodic cost of playing a note at a position, given the notes of the same voice that are already
+     * assigned in the previous and the next chords
+     * @param index the index of the note in the form 4 * chord + voice
+     * @param note the value of the note
+     * @return the sum of the costs of the melodic intervals to the assigned neighbours, 0 if there are none
+     */
+    int neighbours_melodic_cost(int index, int note) const;
+
+    /**
+     * Value selection of VAL_CLOSEST_NEIGHBOUR for a note: the value with the cheapest melodic intervals to the same
+     * voice in the neighbouring chords, ties being broken at random so that restarts still diversify the search
+     * @param x the note to branch on
+     * @param i the index of the note in fullChordsVoicing
+     * @param rnd the random generator breaking the ties
+     * @return the value to try first
+     */
+    int closest_neighbour_note(IntVar x, int i, Rnd &rnd) const;
+
+    /**
+     * Value selection of VAL_CLOSEST_NEIGHBOUR for the index of the voicing of a chord: the voicing with the cheapest
+     * melodic intervals to the neighbouring chords, ties being broken at random
+     * @param x the voicing index to branch on
+     * @param i the position of the chord
+     * @param legal the legal voicings of the chord
+     * @param rnd the random generator breaking the ties
+     * @return the index to try first
+     */
+    int closest_neighbour_voicing(IntVar x, int i, const vector<PackedVoicing> &legal, Rnd &rnd) const;
+
 public:
     /**
      * Constructor
@@ -91,10 +191,13 @@ public:
      * @param chordDegs the degrees of the chord of the chord progression
      * @param chordQuals the qualities of the chord of the chord progression
      * @param chordStas the states of the chord of the chord progression (fundamental, 1st inversion,...)
+     * @param options the branching strategy and the bound shared with other engines
      * @return an instance of FourVoiceTexture initialized with the given parameters, constraints and branching strategies
      * posted as well as the cost vector to minimize in lexicographical order
+     * @throws std::invalid_argument if the hint of the options is neither empty nor of size 4 * s
      */
-    FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas);
+    FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas,
+                     const FourVoiceTextureOptions &options = FourVoiceTextureOptions());
 
     /**
      * Constructor to find all optimal solutions (with or without margin) based on the cost vector for one of the best ones.
@@ -125,6 +228,19 @@ public:
 
     IntVarArray getFullVoicing();
 
+    /**
+     * Assigns the notes of all the chords to the given voicing, for example one found by another solving engine
+     * @param voicing the notes of the chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+     */
+    void fix_voicing(const vector<int> &voicing);
+
+    /**
+     * Assigns a single note of the progression, for example to split the search tree into subproblems
+     * @param index the index of the note in the form 4 * chord + voice
+     * @param note the value of the note
+     */
+    void fix_note(int index, int note);
+
     /**
      * Returns the values taken by the variables vars in a solution as a pointer to an integer array
      * @return an array of integers representing the values of the variables in a solution
@@ -155,6 +271,30 @@ public:
      */
     virtual IntVarArgs cost() const;
 
+    /**
+     * Constrains the cost vector to be better than the one of the given solution, and than the best one found by the
+     * other engines sharing the bound
+     * @param best the best solution found so far by this engine
+     */
+    virtual void constrain(const Space &best);
+
+    /**
+     * Called on each restart. Posts the bound of the last solution and the no-goods, as well as the bound shared by the
+     * other engines
+     * @param mi the information about the restart
+     * @return true to perform the restart
+     */
+    virtual bool master(const MetaInfo &mi);
+
+    /**
+     * Called on the space explored after each restart. If large neighbourhood search is enabled and a solution has
+     * been found, all the chords outside of a window are assigned to their value in the last solution. A window
+     * covering the whole progression relaxes every chord, so the search stays complete.
+     * @param mi the information about the restart
+     * @return true if the search of the space is complete, false if it is restricted to a neighbourhood
+     */
+    virtual bool slave(const MetaInfo &mi);
+
     /**
      * returns the parameters in a string
      * @return a string containing the parameters of the problem
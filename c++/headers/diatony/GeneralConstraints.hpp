@@ -14,6 +14,8 @@
  *     - link_melodic_arrays: links the melodic intervals arrays to the fullChordsVoicing array for each voice         *
  *     - link_squared_melodic_arrays: links the absolute melodic intervals arrays to the corresponding melodic arrays *
  *     - link_harmonic_arrays: links the harmonic intervals arrays to the fullChordsVoicing array for each voice       *
+ *     - harmonic_intervals: creates the harmonic intervals between two voices that are not adjacent                  *
+ *     - pitch_classes: creates the pitch classes of notes, or the interval classes of intervals                      *
  *     - restrain_voices_domains: sets the domains of the different voices to their range and gives them their order   *
  *                                                                                                                     *
  ***********************************************************************************************************************/
@@ -31,36 +33,50 @@ void restrain_voices_domains(const Home &home, int nVoices, int n, vector<int> l
                         IntVarArray fullChordsVoicing);
 
 /**
- * Link the melodic intervals arrays to the fullChordsVoicing array
+ * Link the melodic intervals array to the fullChordsVoicing array
  * @param home The instance of the problem
  * @param nVoices the number of voices
  * @param size the number of chords
  * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
- * @param bassMelodicIntervals the melodic intervals of the bass
- * @param tenorMelodicIntervals the melodic intervals of the tenor
- * @param altoMelodicIntervals the melodic intervals of the alto
- * @param sopranoMelodicIntervals the melodic intervals of the soprano
+ * @param allMelodicIntervals the melodic intervals of all voices in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ * where bass0 is the interval of the bass between the first and the second chord
  */
 void link_melodic_arrays(const Home &home, int nVoices, int size,
-                         IntVarArray fullChordsVoicing, IntVarArray bassMelodicIntervals,
-                         IntVarArray altoMelodicIntervals, IntVarArray tenorMelodicIntervals,
-                         IntVarArray sopranoMelodicIntervals);
+                         IntVarArray fullChordsVoicing, IntVarArray allMelodicIntervals);
 
 /**
- * Link the harmonic intervals arrays to the fullChordsVoicing array for each voice
+ * Link the harmonic intervals array to the fullChordsVoicing array for each pair of adjacent voices
  * @param home the instance of the problem
  * @param nVoices the number of voices in the chords
  * @param size the number of chords
  * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
- * @param bassTenorHarmonicIntervals the harmonic intervals between bass and tenor
- * @param bassAltoHarmonicIntervals the harmonic intervals between bass and alto
- * @param bassSopranoHarmonicIntervals the harmonic intervals between bass and soprano
- * @param tenorAltoHarmonicIntervals the harmonic intervals between tenor and alto
- * @param tenorSopranoHarmonicIntervals the harmonic intervals between tenor and soprano
- * @param altoSopranoHarmonicIntervals the harmonic intervals between alto and soprano
+ * @param harmonicIntervals the harmonic intervals between adjacent voices in the form [bassTenor0, tenorAlto0,
+ * altoSoprano0, bassTenor1, ...]
  */
 void link_harmonic_arrays(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
-                          IntVarArray bassTenorHarmonicIntervals,    IntVarArray bassAltoHarmonicIntervals,
-                          IntVarArray bassSopranoHarmonicIntervals,  IntVarArray tenorAltoHarmonicIntervals,
-                          IntVarArray tenorSopranoHarmonicIntervals, IntVarArray altoSopranoHarmonicIntervals);
+                          IntVarArray harmonicIntervals);
+
+/**
+ * Creates the harmonic intervals between two voices that are not adjacent. They are implied by the intervals between
+ * adjacent voices, so they are only needed by the constraints that are stated on them.
+ * @param home the instance of the problem
+ * @param nVoices the number of voices in the chords
+ * @param size the number of chords
+ * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
+ * @param lowerVoice the lower voice
+ * @param upperVoice the upper voice
+ * @return the harmonic intervals between the two voices in each chord
+ */
+IntVarArray harmonic_intervals(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
+                               int lowerVoice, int upperVoice);
+
+/**
+ * Creates the pitch classes [0,11] of an array of notes, or the interval classes of an array of positive intervals. Each
+ * class is channelled to its value with a single element constraint on a table of classes, which is domain consistent,
+ * so the rules stated on classes share these variables instead of posting their own modulo.
+ * @param home the instance of the problem
+ * @param values the notes [0,127] or the positive intervals
+ * @return the classes of the values, in the same order
+ */
+IntVarArray pitch_classes(const Home &home, const IntVarArray &values);
 #endif
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "../aux/Tonality.hpp"
 #include "../aux/Utilities.hpp"
+#include "ChordContent.hpp"
 
 /***********************************************************************************************************************
  *                                                                                                                     *
@@ -16,6 +17,8 @@
  *      - set_bass: sets the bass of the chord according to the state of the chord                                     *
  *      - chord_note_occurrence_fundamental_state: sets the number of times each note in the chord are present for     *
  *          fundamental state chords                                                                                   *
+ *      - chord_content_decomposition: enforces the occurrences of the notes of a chord with count constraints and     *
+ *          counts its different values and notes with nvalues constraints                                             *
  *                                                                                                                     *
  ***********************************************************************************************************************/
 
@@ -57,11 +60,12 @@ void set_bass(const Home &home, Tonality *tonality, int degree, int quality, int
  * @param tonality the tonality of the piece
  * @param nDifferentValuesInDiminishedChord the number of different values in the diminished chord
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_fundamental_state(Home home, int nVoices, int pos, vector<int> degree, vector<int> quality,
                                              Tonality *tonality, const IntVarArgs &currentChord,
                                              const IntVar &nDifferentValuesInDiminishedChord,
-                                             const IntVar &nOfNotesInChord);
+                                             const IntVar &nOfNotesInChord, ChordOccurrences &occurrences);
 
 /***********************************************************************************************************************
  *                                                                                                                     *
@@ -81,11 +85,12 @@ void chord_note_occurrence_fundamental_state(Home home, int nVoices, int pos, ve
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
  * @param bassMelodicIntervals the array containing the melodic intervals of the bass
  * @param sopranoMelodicIntervals the array containing the melodic intervals of the soprano
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int currentPos, Tonality *tonality,
                                            vector<int> degrees, vector<int> qualities,
                                            const IntVarArgs &currentChord, IntVarArray bassMelodicIntervals,
-                                           IntVarArray sopranoMelodicIntervals);
+                                           IntVarArray sopranoMelodicIntervals, ChordOccurrences &occurrences);
 
 /***********************************************************************************************************************
  *                                                                                                                     *
@@ -103,9 +108,11 @@ void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int
  * @param degrees the degree of the chord
  * @param qualities the qualities of the chords
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_second_inversion(const Home& home, int size, int nVoices, int currentPos, Tonality *tonality,
-                                            vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord);
+                                            vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord,
+                                            ChordOccurrences &occurrences);
 
 /**
  *
@@ -117,7 +124,23 @@ void chord_note_occurrence_second_inversion(const Home& home, int size, int nVoi
  * @param degrees
  * @param qualities
  * @param currentChord
+ * @param occurrences
  */
 void chord_note_occurrence_third_inversion(const Home& home, int size, int nVoices, int currentPos, Tonality *tonality,
-                                           vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord);
+                                           vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord,
+                                           ChordOccurrences &occurrences);
+
+/**
+ * Enforces the bounds on the occurrences of each note of a chord with count constraints, and counts the different
+ * values and notes (regardless of their octave) of the chord with nvalues constraints. This is the decomposition of the
+ * ChordContent propagator.
+ * @param home the instance of the problem
+ * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param currentChordNotes the pitch classes of the notes of the chord
+ * @param occurrences the bounds on the occurrences of each note
+ * @param nOfValues the number of different values in the chord
+ * @param nOfNotes the number of different notes in the chord
+ */
+void chord_content_decomposition(const Home &home, const IntVarArgs &currentChord, const IntVarArgs &currentChordNotes,
+                                 const ChordOccurrences &occurrences, const IntVar &nOfValues, const IntVar &nOfNotes);
 #endif
\ No newline at end of file
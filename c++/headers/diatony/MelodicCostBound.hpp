@@ -0,0 +1,107 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator computing a lower bound on the cost of the melodic intervals from the domains of the notes
+//
+#ifndef MELODICCOSTBOUND_HPP
+#define MELODICCOSTBOUND_HPP
+
+#include "../aux/Utilities.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                               MelodicCostBound class                                                *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This propagator bounds the cost of the melodic intervals (the sum of the weights of MELODIC_INTERVAL_COSTS) from the
+ * domains of the notes. For each voice, the cheapest melody going through the remaining candidate notes is a shortest
+ * path in a layered graph with one layer per chord, where an edge between two notes of successive chords weighs the
+ * cost of their interval (melodic intervals larger than an octave are not allowed). The sum of these shortest paths is
+ * a lower bound on the cost, which is much tighter than the one obtained from the element constraints on the intervals.
+ * A note is removed when the cheapest melody going through it makes the total cost exceed the upper bound of the cost.
+ */
+class MelodicCostBound : public MixNaryOnePropagator<Int::IntView, Int::PC_INT_DOM, Int::IntView, Int::PC_INT_BND> {
+protected:
+    using MixNaryOnePropagator<Int::IntView, Int::PC_INT_DOM, Int::IntView, Int::PC_INT_BND>::x;    // the notes
+    using MixNaryOnePropagator<Int::IntView, Int::PC_INT_DOM, Int::IntView, Int::PC_INT_BND>::y;    // the cost
+    int                         nOfVoices;                                  // the number of voices
+
+    /**
+     * Constructor for posting
+     * @param home the space
+     * @param notes the notes of the chord progression
+     * @param cost the cost of the melodic intervals
+     * @param voices the number of voices
+     */
+    MelodicCostBound(Home home, ViewArray<Int::IntView> &notes, Int::IntView cost, int voices);
+
+    /**
+     * Constructor for cloning
+     * @param home the space
+     * @param p the propagator to copy
+     */
+    MelodicCostBound(Space &home, MelodicCostBound &p);
+
+    /**
+     * Computes the cost of the cheapest melody of a voice ending on each candidate note of each chord
+     * @param voice the voice
+     * @param values the candidate notes of all the notes of the progression, one note after the other
+     * @param first the index in values of the first candidate of each note, followed by the number of candidates
+     * @param forward filled for the notes of the voice with the cost of the cheapest melody from the first chord to each
+     * candidate, indexed as values
+     * @param backward filled for the notes of the voice with the cost of the cheapest melody from each candidate to the
+     * last chord, indexed as values
+     * @return the cost of the cheapest melody of the voice, INT_MAX if the voice has no melody
+     */
+    int shortest_melody(int voice, const int* values, const int* first, int* forward, int* backward) const;
+
+public:
+    /**
+     * Posts the propagator
+     * @param home the space
+     * @param notes the notes of the chord progression in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+     * @param cost the cost of the melodic intervals
+     * @param voices the number of voices
+     * @return ES_OK
+     */
+    static ExecStatus post(Home home, ViewArray<Int::IntView> &notes, Int::IntView cost, int voices);
+
+    /**
+     * Copies the propagator during cloning
+     * @param home the space
+     * @return a copy of the propagator
+     */
+    virtual Propagator* copy(Space &home);
+
+    /**
+     * Returns the cost of the propagator: the shortest paths are quadratic in the size of the domains
+     * @param home the space
+     * @param med the modification events
+     * @return the cost of the propagator
+     */
+    virtual PropCost cost(const Space &home, const ModEventDelta &med) const;
+
+    /**
+     * Updates the lower bound of the cost and removes the notes that cannot meet its upper bound
+     * @param home the space
+     * @param med the modification events
+     * @return the status of the propagation
+     */
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &med);
+};
+
+/**
+ * Bounds the cost of the melodic intervals of all voices with a single MelodicCostBound propagator. It comes on top of
+ * the element constraints of compute_cost_for_melodic_intervals, which still define the cost of each interval.
+ * @param home the instance of the problem
+ * @param nOfVoices the number of voices
+ * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param costOfMelodicIntervals the cost of the melodic intervals (weighted sum)
+ */
+void melodic_cost_bound(Home home, int nOfVoices, const IntVarArray &fullChordsVoicing,
+                        const IntVar &costOfMelodicIntervals);
+
+#endif
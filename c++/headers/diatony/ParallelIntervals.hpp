@@ -0,0 +1,100 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator forbidding parallel intervals between all the pairs of voices of two successive chords
+//
+#ifndef PARALLELINTERVALS_HPP
+#define PARALLELINTERVALS_HPP
+
+#include "../aux/Utilities.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                               ParallelIntervals class                                               *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This propagator enforces the rule of forbid_parallel_interval for the 6 pairs of voices of two successive chords at
+ * once, on the 8 notes involved: two voices cannot form the same forbidden interval (modulo the octave) in both chords,
+ * unless neither voice moves. Whenever 3 of the 4 notes of a pair are assigned, the values of the last one that would
+ * form a parallel interval are removed, whether that note is in the first or in the second chord.
+ */
+class ParallelIntervals : public NaryPropagator<Int::IntView, Int::PC_INT_VAL> {
+protected:
+    using NaryPropagator<Int::IntView, Int::PC_INT_VAL>::x;                 // [bass0, tenor0, alto0, soprano0, bass1, ...]
+    unsigned int                forbidden;                                  // bit i is set if the interval i is forbidden
+
+    /**
+     * Constructor for posting
+     * @param home the space
+     * @param notes the notes of the two chords
+     * @param forbiddenIntervals the bit mask of the forbidden intervals modulo the octave
+     */
+    ParallelIntervals(Home home, ViewArray<Int::IntView> &notes, unsigned int forbiddenIntervals);
+
+    /**
+     * Constructor for cloning
+     * @param home the space
+     * @param p the propagator to copy
+     */
+    ParallelIntervals(Space &home, ParallelIntervals &p);
+
+    /**
+     * Returns whether two voices form the same forbidden interval in both chords
+     * @param lowerCurrent the note of the lower voice in the first chord
+     * @param upperCurrent the note of the upper voice in the first chord
+     * @param lowerNext the note of the lower voice in the second chord
+     * @param upperNext the note of the upper voice in the second chord
+     * @return true if the motion is forbidden
+     */
+    bool is_parallel(int lowerCurrent, int upperCurrent, int lowerNext, int upperNext) const;
+
+    /**
+     * Returns whether a harmonic interval is forbidden. As in forbid_parallel_interval, the interval modulo the octave
+     * is compared to the forbidden ones
+     * @param interval a harmonic interval
+     * @return true if the interval is forbidden
+     */
+    bool is_forbidden(int interval) const;
+
+public:
+    /**
+     * Posts the propagator
+     * @param home the space
+     * @param notes the notes of the two chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+     * @param forbiddenIntervals the bit mask of the forbidden intervals modulo the octave
+     * @return ES_OK. Notes that already form parallel intervals make the first propagation fail
+     */
+    static ExecStatus post(Home home, ViewArray<Int::IntView> &notes, unsigned int forbiddenIntervals);
+
+    /**
+     * Copies the propagator during cloning
+     * @param home the space
+     * @return a copy of the propagator
+     */
+    virtual Propagator* copy(Space &home);
+
+    /**
+     * Removes the values forming parallel intervals from the notes
+     * @param home the space
+     * @param med the modification events
+     * @return the status of the propagation
+     */
+    virtual ExecStatus propagate(Space &home, const ModEventDelta &med);
+};
+
+/**
+ * Forbids a list of parallel intervals between all pairs of voices when moving from the chord at currentPosition to
+ * the next one, with a single ParallelIntervals propagator
+ * @param home the instance of the problem
+ * @param currentPosition the current position in the chord progression
+ * @param nOfVoices the number of voices
+ * @param intervals the list of intervals to forbid
+ * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ */
+void parallel_intervals(Home home, int currentPosition, int nOfVoices, const vector<int> &intervals,
+                        const IntVarArray &fullChordsVoicing);
+
+#endif
@@ -12,31 +12,25 @@
  * and an array containing the number of different notes in each diminished chord (other chords are set to 0).
  * Here, the preference is that they should be used in 3 voices instead of 4.
  * @param home the instance of the problem
- * @param nVoices the number of voices
  * @param size the number of chords
  * @param chordStates the state of the chord (inversion)
  * @param chordQualities the quality of the chord (diminished, minor, major, augmented,...)
- * @param fullChordsVoicing the array containing all the chords in the form
- *          [bass0, alto0, tenor0, soprano0, bass1, alto1, tenor1, soprano1, ...]
+ * @param nOfDifferentValues the array containing the number of different values in each chord
  * @param nOfDifferentNotes the array containing the number of different notes in each diminished chord.
  * @param costVar the variable that will contain the number of diminished chords that don't respect the preference
  */
-void compute_diminished_chords_cost(const Home &home, int nVoices, int size, vector<int> chordStates,
-                                    vector<int> chordQualities, IntVarArray fullChordsVoicing,
-                                    IntVarArray nOfDifferentNotes, const IntVar &costVar);
+void compute_diminished_chords_cost(const Home &home, int size, vector<int> chordStates, vector<int> chordQualities,
+                                    IntVarArray nOfDifferentValues, IntVarArray nOfDifferentNotes,
+                                    const IntVar &costVar);
 
 /**
  * Computes the cost for the number of notes in a chord, that is the number of chords that have less than 4 different
  * values
  * @param home the instance of the problem
- * @param nVoices the number of voices
- * @param size the size of the chord
- * @param fullChordsVoicing the array containing all the chords in the form [bass, alto, tenor, soprano]
  * @param nOfDifferentNotes the array containing the number of different notes in each chord
  * @param costVar the variable that will contain the cost
  */
-void compute_n_of_notes_in_chord_cost(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
-                                      IntVarArray nOfDifferentNotes, const IntVar &costVar);
+void compute_n_of_notes_in_chord_cost(const Home &home, const IntVarArray &nOfDifferentNotes, const IntVar &costVar);
 
 /**
  * This function counts the number of times when a common note in the soprano voice when moving from a chord in first
@@ -57,15 +51,13 @@ void compute_cost_for_common_note_in_soprano(const Home &home, IntVarArray commo
  * This function counts the number of incomplete chords
  * @param home the instance of the problem
  * @param size the number of chords in the chord progression
- * @param nVoices the number of voices in the chords
- * @param fullChordsVoicing all the notes of all the chords
+ * @param nNotesInChords the number of notes in each chord if it is complete
  * @param nDiffNotesInChord An IntVarArray counting the number of different notes (regardless of their octave) in
  * each chord
  * @param nOfIncompleteChords an IntVar counting the number of incomplete chords in the chord progression
  */
-void compute_cost_for_incomplete_chords(const Home &home, int nVoices, int size, const IntArgs &nNotesInChords,
-                                        IntVarArray fullChordsVoicing, IntVarArray nDiffNotesInChord,
-                                        const IntVar &nOfIncompleteChords);
+void compute_cost_for_incomplete_chords(const Home &home, int size, const IntArgs &nNotesInChords,
+                                        const IntVarArray &nDiffNotesInChord, const IntVar &nOfIncompleteChords);
 
 /**
  * This function sets the cost for the number of times when there is a common note in the same voice between consecutive
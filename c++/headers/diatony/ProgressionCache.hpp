@@ -0,0 +1,85 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A cache of solved progressions that serves the same progression in other keys by transposition.
+//
+#ifndef PROGRESSIONCACHE_HPP
+#define PROGRESSIONCACHE_HPP
+
+#include <mutex>
+
+#include "../aux/Utilities.hpp"
+
+using namespace std;
+
+/**
+ * The key independent form of a progression
+ */
+struct ProgressionKey {
+    int                         mode;                                       // the mode of the tonality
+    vector<int>                 chords;                                     // the chord degrees of the progression
+    vector<int>                 qualities;                                  // the qualities of the chords
+    vector<int>                 states;                                     // the states of the chords
+
+    bool operator<(const ProgressionKey &other) const;
+};
+
+/**
+ * A progression solved in a given key
+ */
+struct SolvedProgression {
+    int                         tonic;                                      // the tonic of the key it was solved in
+    vector<int>                 voicing;                                    // [bass0, tenor0, alto0, soprano0, bass1, ...]
+    vector<int>                 costs;                                      // the cost vector in lexicographical order
+    bool                        optimal;                                    // true if a search completed in this key
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                               ProgressionCache class                                                *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This class stores the solutions of progressions by their key independent form. Since the rules and the costs only
+ * depend on the intervals, a solution in one key gives a solution of the same cost in another key once transposed,
+ * unless the transposed voicing leaves the ranges of the voices. All the methods are thread safe.
+ */
+class ProgressionCache {
+protected:
+    mutable std::mutex                                      lock;           // protects the solutions
+    map<ProgressionKey, vector<SolvedProgression>>          solutions;      // the solutions of each progression, one per key
+
+public:
+    /**
+     * Transposes a voicing by the smallest shift that brings the tonic of a key to another one, up or down, while
+     * keeping every voice in its range
+     * @param voicing the notes of the progression in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+     * @param fromTonic the tonic of the key of the voicing
+     * @param toTonic the tonic of the target key
+     * @param transposed filled with the transposed voicing. If no transposition keeps the voices in their ranges,
+     * it is transposed by the smallest shift
+     * @return true if a transposition keeps all the voices in their ranges
+     */
+    static bool transpose(const vector<int> &voicing, int fromTonic, int toTonic, vector<int> &transposed);
+
+    /**
+     * Returns the solutions of a progression
+     * @param key the key independent form of the progression
+     * @return the solutions of the progression, one per key it was solved in, optimal solutions first
+     */
+    vector<SolvedProgression> get(const ProgressionKey &key) const;
+
+    /**
+     * Adds the solution of a progression in a key. It replaces the previous solution in that key if it is better
+     * @param key the key independent form of the progression
+     * @param solution the solution
+     */
+    void add(const ProgressionKey &key, const SolvedProgression &solution);
+
+    /**
+     * Returns the number of progressions in the cache
+     * @return the number of key independent progressions solved at least once
+     */
+    int get_size() const;
+};
+
+#endif
@@ -0,0 +1,126 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A persistent store of the best solutions found for each problem, kept in a memory-mapped,
+//                append-only file so that it survives restarts and can be shared by several processes.
+//
+#ifndef SOLUTIONSTORE_HPP
+#define SOLUTIONSTORE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "../aux/Utilities.hpp"
+
+using namespace std;
+
+/**
+ * A problem in its canonical form, everything its solutions depend on
+ */
+struct StoredProblem {
+    int                         tonic;                                      // the tonic of the tonality
+    int                         mode;                                       // the mode of the tonality
+    vector<int>                 chords;                                     // the chord degrees of the progression
+    vector<int>                 qualities;                                  // the qualities of the chords
+    vector<int>                 states;                                     // the states of the chords
+
+    /**
+     * Returns the hash of the canonical form of the problem (64 bits FNV-1a)
+     * @return the hash of the problem
+     */
+    uint64_t hash() const;
+};
+
+/**
+ * The best solution found for a problem
+ */
+struct StoredSolution {
+    vector<int>                 voicing;                                    // [bass0, tenor0, alto0, soprano0, bass1, ...]
+    vector<int>                 costs;                                      // the cost vector in lexicographical order
+    bool                        optimal;                                    // true if the solution is proven optimal
+    int                         modelVersion;                               // the version of the model it was found with
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                 SolutionStore class                                                 *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This class stores the best solution found for each problem in a file mapped in memory. The file is a header followed
+ * by records that are only ever appended: a better solution for a problem is appended after the previous one, which is
+ * then ignored. An index from the hash of each problem to its latest record is built when the file is opened, so that a
+ * lookup is a hash table access followed by a comparison of the problem stored in the record. The records appended by
+ * other processes are indexed on the next access. All the methods are thread safe.
+ */
+class SolutionStore {
+protected:
+    mutable std::mutex                                      lock;           // protects everything below
+    int                                                     file;           // the file descriptor of the store
+    mutable char*                                           data;           // the mapped file
+    mutable size_t                                          capacity;       // the size of the mapping in bytes
+    mutable uint64_t                                        indexed;        // the number of bytes already indexed
+    mutable unordered_multimap<uint64_t, uint64_t>          index;          // the offset of the records of each hash
+
+    /**
+     * Maps the whole file in memory, growing it to at least a given size
+     * @param minSize the minimum size of the file in bytes
+     */
+    void map_file(size_t minSize) const;
+
+    /**
+     * Indexes the records appended since the last call, remapping the file if another process has grown it
+     * @throws std::runtime_error if a record does not fit in the bytes used in the file
+     */
+    void refresh() const;
+
+    /**
+     * Returns the offset of the latest record of a problem
+     * @param problem the problem
+     * @return the offset of the record, 0 if the problem is not in the store
+     */
+    uint64_t find(const StoredProblem &problem) const;
+
+public:
+    /**
+     * Constructor. Opens the store, creating the file if it does not exist
+     * @param path the path of the file
+     * @throws std::runtime_error if the file cannot be opened, is not a solution store or is corrupted
+     */
+    explicit SolutionStore(const string &path);
+
+    /**
+     * Destructor. Unmaps and closes the file
+     */
+    ~SolutionStore();
+
+    SolutionStore(const SolutionStore&) = delete;
+    SolutionStore& operator=(const SolutionStore&) = delete;
+
+    /**
+     * Looks a problem up in the store
+     * @param problem the problem
+     * @param solution filled with the best solution stored for the problem
+     * @return true if the problem is in the store
+     * @throws std::runtime_error if the store is corrupted
+     */
+    bool get(const StoredProblem &problem, StoredSolution &solution) const;
+
+    /**
+     * Appends a solution of a problem to the store if it is better than the stored one, or as good but proven optimal,
+     * or if the stored one was found with another version of the model
+     * @param problem the problem
+     * @param solution the solution
+     * @return true if the solution was appended
+     * @throws std::runtime_error if the store is corrupted
+     */
+    bool add(const StoredProblem &problem, const StoredSolution &solution);
+
+    /**
+     * Returns the number of problems in the store
+     * @return the number of distinct problems
+     */
+    int get_size() const;
+};
+
+#endif
@@ -5,7 +5,64 @@
 #ifndef DIATONY_SOLVEPROBLEM_HPP
 #define DIATONY_SOLVEPROBLEM_HPP
 
+#include <functional>
+
 #include "FourVoiceTexture.hpp"
+#include "VoicingRules.hpp"
+#include "ProgressionCache.hpp"
+#include "SolutionStore.hpp"
+
+/**
+ * Called for each improving solution found during search. The solution is a view that is deleted when the callback
+ * returns: it must be copied to be kept. The costs are the cost vector of the solution in lexicographical order.
+ * Returns false to stop the search.
+ */
+typedef function<bool(FourVoiceTexture &solution, const vector<int> &costs)> SolutionCallback;
+
+/**
+ * Returns the cutoff of the restart based searches: restarts after a linear number of failures, merged with a geometric
+ * sequence starting at the square of the number of notes
+ * @param size the number of chords of the problem
+ * @return the cutoff, to be given to the options of a search
+ */
+Search::Cutoff* restart_cutoff(int size);
+
+/**
+ * Computes the lower bound of each cost of a solution, given that the costs before it are equal to the ones of the
+ * solution. The bounds are obtained by propagation on a copy of the root space, after posting the equalities one cost
+ * at a time. A solution whose cost meets its bound cannot be improved on that cost by any solution with the same
+ * earlier costs.
+ * @param root the problem after the initial propagation
+ * @param costs the cost vector of the solution
+ * @return the lower bound of each cost
+ */
+vector<int> cost_bounds(FourVoiceTexture* root, const vector<int> &costs);
+
+/**
+ * Finds an optimal solution for a four voice texture problem and streams every improving solution found during search
+ * to a callback. No solution is kept: the callback copies the ones it needs. The search stops as soon as the melodic
+ * cost of a solution meets its lower bound given the costs before it (see cost_bounds). If print is true, the gap
+ * between the melodic cost of each solution and that bound is reported.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param onSolution the callback called for each improving solution (see SolutionCallback)
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was neither stopped by the time limit, nor by the callback,
+ * nor cancelled, or if it stopped on a solution whose costs all meet their bounds
+ * @param options the branching options of the problem, for example a hint to start from
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search. The
+ * time spent in pause does not count in the time limit
+ * @return the number of solutions found
+ */
+int solve_diatony_problem_stream(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                 vector<int> states, const SolutionCallback &onSolution, bool print = false,
+                                 double timeLimit = 60000, bool* complete = nullptr,
+                                 const FourVoiceTextureOptions &options = FourVoiceTextureOptions(),
+                                 CancellationToken* token = nullptr);
 
 /**
  * Finds an optimal solution for a four voice texture problem and returns the list of all intermediate solutions found
@@ -16,10 +73,229 @@
  * @param qualities the qualities of the chords
  * @param states the states of the chords
  * @param print
- * @return A list of FourVoiceTexture* representing all the solutions found during search
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was not stopped by the time limit
+ * @param options the branching options of the problem, for example a hint to start from
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search
+ * @return A list of FourVoiceTexture* representing all the solutions found during search, owned by the caller. Use
+ * solve_diatony_problem_stream to avoid copying every intermediate solution.
  */
 vector<FourVoiceTexture *> solve_diatony_problem(int size, Tonality *tonality, vector<int> chords, vector<int> qualities,
-                                                 vector<int> states, bool print = false);
+                                                 vector<int> states, bool print = false, double timeLimit = 60000,
+                                                 bool* complete = nullptr,
+                                                 const FourVoiceTextureOptions &options = FourVoiceTextureOptions(),
+                                                 CancellationToken* token = nullptr);
+
+/**
+ * Finds an optimal solution for a four voice texture problem, reusing the solutions of the same progression in other
+ * keys. If the progression was solved in another key, its solution is transposed and checked against the model. If
+ * the transposed solution leaves the ranges of the voices or violates the model, the problem is solved with the
+ * transposed solution as a hint. The solution found is added to the cache.
+ * @param cache the solutions of the progressions solved so far
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds, if a search is needed
+ * @param complete if not nullptr, set to true if the solution comes from a search in this key that was not stopped by
+ * the time limit. A solution transposed from another key is never reported as optimal: the ranges of the voices do not
+ * move with the key, so other voicings may be better in this key
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search, if a
+ * search is needed
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_cached(ProgressionCache &cache, int size, Tonality* tonality, vector<int> chords,
+                                               vector<int> qualities, vector<int> states, bool print = false,
+                                               double timeLimit = 60000, bool* complete = nullptr,
+                                               CancellationToken* token = nullptr);
+
+/**
+ * A progression to harmonize in a batch
+ */
+struct DiatonyJob {
+    Tonality*                   tonality;                                   // the tonality of the progression
+    vector<int>                 chords;                                     // the chord degrees of the progression
+    vector<int>                 qualities;                                  // the qualities of the chords
+    vector<int>                 states;                                     // the states of the chords
+    double                      timeLimit;                                  // the time budget in milliseconds
+    CancellationToken*          token;                                      // cancels the job if not nullptr
+
+    DiatonyJob(Tonality* t, vector<int> c, vector<int> q, vector<int> s, double time = 60000,
+               CancellationToken* cancel = nullptr) :
+            tonality(t), chords(std::move(c)), qualities(std::move(q)), states(std::move(s)), timeLimit(time),
+            token(cancel) {}
+};
+
+/**
+ * The result of a progression harmonized in a batch. Only the values are kept so that no Gecode space outlives the
+ * batch
+ */
+struct DiatonyResult {
+    vector<int>                 voicing;                                    // [bass0, tenor0, alto0, soprano0, bass1, ...], empty if no solution was found
+    vector<int>                 costs;                                      // the cost vector in lexicographical order
+    bool                        optimal = false;                            // true if the search completed within the time budget
+    double                      time = 0;                                   // the time taken in seconds
+};
+
+/**
+ * Harmonizes a batch of progressions concurrently on a work stealing thread pool. Each job is solved with
+ * solve_diatony_problem within its own time budget, or with solve_diatony_problem_cached if a cache is given.
+ * @param jobs the progressions to harmonize
+ * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+ * @param cache if not nullptr, the cache used to share the solutions of the same progression in different keys
+ * @return the results in the same order as the jobs
+ */
+vector<DiatonyResult> solve_diatony_batch(const vector<DiatonyJob> &jobs, int nOfThreads = 0,
+                                          ProgressionCache* cache = nullptr);
+
+/**
+ * Finds the best solution it can for a four voice texture problem within a wall-clock deadline. A first solution is
+ * searched by depth first search without optimization within a share of the deadline. The rest of the deadline is
+ * spent in branch and bound, starting from that first solution as a hint.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param deadline the wall-clock budget in milliseconds, model construction included
+ * @param optimal if not nullptr, set to true if the search was complete: the solution returned is optimal or, if
+ * nullptr is returned, the problem is proven to have no solution. nullptr with optimal false means that no solution was
+ * found before the deadline
+ * @param print
+ * @param firstSolutionShare the share of the deadline given to the search for a first solution, in ]0,1]
+ * @return A FourVoiceTexture* representing the best solution found within the deadline. If no solution is found,
+ * returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_deadline(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                                 vector<int> states, double deadline = 200, bool* optimal = nullptr,
+                                                 bool print = false, double firstSolutionShare = 0.25);
+
+/**
+ * Finds an optimal solution for a four voice texture problem by dynamic programming over the legal voicings of each
+ * chord. The solution is then assigned in a FourVoiceTexture instance so that it is checked by the constraint model.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @return A FourVoiceTexture* representing the optimal solution. If no solution exists, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_dp(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                           vector<int> states, bool print = false);
+
+/**
+ * Finds an optimal solution for a four voice texture problem by racing several differently configured restart based
+ * branch and bound engines in parallel threads. The engines vary the variable selection heuristic, the random seed of
+ * the value selection and the cutoff policy, and share the best cost vector found so far. The first engine uses the
+ * default configuration of solve_diatony_problem.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param nOfWorkers the number of engines, 0 to use one engine per hardware thread
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return A FourVoiceTexture* representing the best solution found by any engine. If no solution is found, returns
+ * nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_portfolio(int size, Tonality* tonality, vector<int> chords,
+                                                  vector<int> qualities, vector<int> states, int nOfWorkers = 0,
+                                                  bool print = false, double timeLimit = 60000);
+
+/**
+ * Finds an optimal solution for a four voice texture problem using several threads. Two modes are available:
+ * - the default mode uses the parallel restart based branch and bound of Gecode. The threads share the best solution,
+ *   but the order in which they find solutions depends on the scheduling, so two runs can return different optimal
+ *   solutions with different statistics.
+ * - the deterministic mode splits the search tree into independent subproblems that are solved in parallel by
+ *   sequential engines. The results are combined by cost vector, then by subproblem index, so two runs with the same
+ *   number of threads return the same solution and the same statistics as long as the search completes within the
+ *   time limit. The number of subproblems is derived from the number of threads (4 per thread), so runs with a
+ *   different number of threads split the tree differently: they find the same optimal cost, but possibly another
+ *   solution of that cost, with other statistics.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+ * @param deterministic true to use the deterministic mode
+ * @param print
+ * @param statistics if not nullptr, filled with the statistics of the search (summed over all subproblems in the
+ * deterministic mode)
+ * @param optimal if not nullptr, set to true if the search was complete, so that the solution is proven optimal
+ * @param hint a voicing to try first (warm start), or empty
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_parallel(int size, Tonality* tonality, vector<int> chords,
+                                                 vector<int> qualities, vector<int> states, int nOfThreads = 0,
+                                                 bool deterministic = false, bool print = false,
+                                                 Search::Statistics* statistics = nullptr, bool* optimal = nullptr,
+                                                 const vector<int> &hint = vector<int>(), double timeLimit = 60000);
+
+/**
+ * Finds a near optimal solution for a four voice texture problem by large neighbourhood search. Once a first solution
+ * is found, each restart keeps all the chords of the best solution except a window of consecutive chords, which is
+ * re-optimized. The window is chosen at random or around the chords that cost the most in the best solution. The
+ * search never proves optimality and runs until the time limit, which makes it suited to long progressions.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param window the number of chords re-optimized at each restart, 0 to choose it depending on the size
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param print
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_lns(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                            vector<int> states, int window = 0, double timeLimit = 5000,
+                                            bool print = false);
+
+/**
+ * Finds a near optimal solution for a long progression by solving it as a sequence of small problems. The progression
+ * is cut after the cadences (perfect, plagal and interrupted) into segments that are harmonized in parallel. Each
+ * segment is solved with windows of consecutive chords that overlap by one chord: the first chord of a window is fixed
+ * to the last chord of the previous window. Each window is solved with the chords next to it as context, so that its
+ * chords follow the rules of the inner chords of a progression. If a window has no solution with that boundary, it is
+ * extended backward over the previous window. The chords on both sides of a cut are then re-optimized with their
+ * neighbours fixed. The result is checked and evaluated by the model of the whole progression, and repaired by a
+ * search of the whole progression starting from it if it breaks a rule.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param window the number of chords in each window (at least 2)
+ * @param windowTimeLimit the time limit of the search of each window in milliseconds
+ * @param nOfThreads the number of threads used for the segments, 0 to use one thread per hardware thread
+ * @param compare true to also solve the whole progression at once and report the gap between the cost vectors
+ * @param print
+ * @return A FourVoiceTexture* representing the solution. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_windows(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                                vector<int> states, int window = 8, double windowTimeLimit = 10000,
+                                                int nOfThreads = 0, bool compare = false, bool print = false);
+
+/**
+ * Looks up the optimal solution of a four voice texture problem in a solution store, without building its model. Only
+ * a solution proven optimal with the current version of the model is returned, so it can be used without search.
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param store the store of the solutions of the problems solved so far
+ * @param solution filled with the voicing and the cost vector of the stored solution
+ * @return true if the store has a solution of the problem proven optimal with the current version of the model
+ */
+bool find_stored_optimal_solution(Tonality* tonality, const vector<int> &chords, const vector<int> &qualities,
+                                  const vector<int> &states, const SolutionStore &store, StoredSolution &solution);
+
 /**
  * Finds an optimal solution for a four voice texture problem.
  * @param size the number of chords
@@ -28,11 +304,17 @@ vector<FourVoiceTexture *> solve_diatony_problem(int size, Tonality *tonality, v
  * @param qualities the qualities of the chords
  * @param states the states of the chords
  * @param print
+ * @param engine the engine used to solve the problem (see solving_engines)
+ * @param store if not nullptr, the store of the solutions of the problems solved so far. A solution found in the store
+ * that was proven optimal with the current version of the model is returned without search, any other is the hint of
+ * the search (for all the engines but dynamic programming, which needs none). The solution found is written to the
+ * store, proven optimal if the search was complete.
  * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
  * If the best solution is not found during search, returns the last solution found (best so far).
  */
 FourVoiceTexture* solve_diatony_problem_optimal(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
-                                                vector<int> states, bool print = false);
+                                                vector<int> states, bool print = false, int engine = GECODE_ENGINE,
+                                                SolutionStore* store = nullptr);
 
 /**
  * Finds all solutions close to the optimal solution, with a margin percentage of deviation from the cost vector. That
@@ -50,4 +332,28 @@ vector<FourVoiceTexture*> find_optimal_solutions_with_margin(int size, Tonality*
                                                              vector<int> qualities, vector<int> states, vector<int> costs,
                                                              double margin = 0.0);
 
+/**
+ * Finds the best distinct solutions of a four voice texture problem within a margin of the optimal solution in a
+ * single branch and bound search. Instead of requiring each new solution to improve on the last one, the search keeps
+ * an archive of the best solutions found so far and only requires new solutions to improve on the worst archived one
+ * once the archive is full.
+ * @param size the number of chords
+ * @param tonality the tonaity of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param margin a percentage of "error" that is allowed to find close to optimal solutions (see SolutionArchive)
+ * @param nOfSolutions the maximum number of solutions kept
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was not stopped by the time limit
+ * @return the best solutions within the margin of the best one, best first. If the search is complete, the first one
+ * is optimal and the others are the best solutions within the margin, up to nOfSolutions.
+ */
+vector<FourVoiceTexture*> solve_diatony_problem_near_optimal(int size, Tonality* tonality, vector<int> chords,
+                                                             vector<int> qualities, vector<int> states,
+                                                             double margin = 0.1, int nOfSolutions = 100,
+                                                             bool print = false, double timeLimit = 60000,
+                                                             bool* complete = nullptr);
+
 #endif //DIATONY_SOLVEPROBLEM_HPP
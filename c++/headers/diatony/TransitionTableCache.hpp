@@ -0,0 +1,90 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A process-wide cache of the tables of legal transitions between two chords, so that they are
+//                enumerated only once for each pair of chord signatures.
+//
+#ifndef TRANSITIONTABLECACHE_HPP
+#define TRANSITIONTABLECACHE_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include "../aux/Utilities.hpp"
+#include "VoicingCache.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/**
+ * Everything the legal transitions between two consecutive chords depend on. The context holds the facts about the
+ * chord after the pair that change the rules between the two chords (see VoicingRules::transition_context).
+ */
+struct TransitionSignature {
+    ChordSignature current;                                                 // the signature of the first chord
+    ChordSignature next;                                                    // the signature of the second chord
+    int context;                                                            // the transition context of the pair
+
+    bool operator<(const TransitionSignature &other) const;
+};
+
+/**
+ * The legal transitions of a pair of chords. A table with more than MAX_TRANSITION_TUPLES tuples is not kept: its
+ * enumeration is abandoned and the rules between the two chords are posted as propagators instead.
+ */
+struct TransitionTable {
+    TupleSet tuples;                                                        // the finalized table, if not too large
+    bool tooLarge = false;                                                  // true if the enumeration was abandoned
+    double enumerationTime = 0;                                             // the time taken to enumerate it (ms)
+};
+
+/**
+ * The size of the cache and the time spent filling it
+ */
+struct TransitionTableStatistics {
+    int nOfTables = 0;                                                      // the number of tables kept
+    long nOfTuples = 0;                                                     // the number of tuples in those tables
+    int nOfTooLarge = 0;                                                    // the number of tables abandoned
+    double enumerationTime = 0;                                             // the time spent enumerating (ms)
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                              TransitionTableCache class                                             *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This class stores the table of the legal transitions of each pair of chord signatures met so far. A table holds one
+ * tuple [bass, tenor, alto, soprano, nextBass, nextTenor, nextAlto, nextSoprano] per legal pair of voicings. It is
+ * shared by all the problems of the process and all its methods are thread safe. The tables are never removed, so the
+ * references it returns stay valid until the end of the process.
+ */
+class TransitionTableCache {
+protected:
+    static std::mutex                                       lock;           // protects the tables
+    static map<TransitionSignature, TransitionTable>        tables;         // the legal transitions of each signature
+
+public:
+    /**
+     * Returns the table of the legal transitions of a pair of chords, enumerating them the first time the pair is met
+     * @param signature the signature of the pair of chords
+     * @param enumerate a function enumerating the legal transitions of the pair of chords
+     * @return the legal transitions of the pair of chords
+     */
+    static const TransitionTable& get(const TransitionSignature &signature,
+                                      const function<TransitionTable()> &enumerate);
+
+    /**
+     * Returns the number of pairs of chords in the cache
+     * @return the number of signatures whose transitions have been enumerated
+     */
+    static int get_size();
+
+    /**
+     * Returns the size of the tables in the cache and the time spent enumerating them
+     * @return the statistics of the cache since the start of the process
+     */
+    static TransitionTableStatistics get_statistics();
+};
+
+#endif
@@ -18,30 +18,33 @@
  *          in fundamental state                                                                                       *
  *      - interrupted_cadence: sets the constraint for a fifth degree followed by a sixth degree in     *
  *          funda mental state                                                                                         *
+ *      - legal_transitions: restrains two consecutive chords to a table of legal transitions                          *
+ *          (replaces the other constraints between the two chords)                                                    *
  *                                                                                                                     *
  ***********************************************************************************************************************/
 
 /**
- * Forbids a list of parallel intervals between two voices. This calls the forbid_parallel_interval function
+ * Forbids a list of parallel intervals between two voices when moving from the chord at currentPosition to the next
+ * one. This calls the forbid_parallel_interval function
  * @param home the instance of the problem
- * @param size the size of the chord progression
+ * @param currentPosition the current position in the chord progression
  * @param nOfVoices the number of voices
  * @param intervals the list of intervals to forbid
  * @param FullChordsVoicing the array containing all the notes of the chords in the progression
- * @param bassTenorHarmonicIntervals the array containing the harmonic intervals between bass and tenor
- * @param bassAltoHarmonicIntervals the array containing the harmonic intervals between bass and alto
- * @param bassSopranoHarmonicIntervals the array containing the harmonic intervals between bass and soprano
- * @param tenorAltoHarmonicIntervals the array containing the harmonic intervals between tenor and alto
- * @param tenorSopranoHarmonicIntervals the array containing the harmonic intervals between tenor and soprano
- * @param altoSopranoHarmonicIntervals the array containing the harmonic intervals between alto and soprano
+ * @param bassTenorIntervalClasses the array containing the classes of the harmonic intervals between bass and tenor
+ * @param bassAltoIntervalClasses the array containing the classes of the harmonic intervals between bass and alto
+ * @param bassSopranoIntervalClasses the array containing the classes of the harmonic intervals between bass and soprano
+ * @param tenorAltoIntervalClasses the array containing the classes of the harmonic intervals between tenor and alto
+ * @param tenorSopranoIntervalClasses the array containing the classes of the harmonic intervals between tenor and soprano
+ * @param altoSopranoIntervalClasses the array containing the classes of the harmonic intervals between alto and soprano
  */
-void forbid_parallel_intervals(const Home &home, int size, int nOfVoices, const vector<int> &intervals,
-                               const IntVarArray &FullChordsVoicing, const IntVarArray &bassTenorHarmonicIntervals,
-                               const IntVarArray &bassAltoHarmonicIntervals,
-                               const IntVarArray &bassSopranoHarmonicIntervals,
-                               const IntVarArray &tenorAltoHarmonicIntervals,
-                               const IntVarArray &tenorSopranoHarmonicIntervals,
-                               const IntVarArray &altoSopranoHarmonicIntervals);
+void forbid_parallel_intervals(const Home &home, int currentPosition, int nOfVoices, const vector<int> &intervals,
+                               const IntVarArray &FullChordsVoicing, const IntVarArray &bassTenorIntervalClasses,
+                               const IntVarArray &bassAltoIntervalClasses,
+                               const IntVarArray &bassSopranoIntervalClasses,
+                               const IntVarArray &tenorAltoIntervalClasses,
+                               const IntVarArray &tenorSopranoIntervalClasses,
+                               const IntVarArray &altoSopranoIntervalClasses);
 
 /**
  * Forbids a given parallel interval between two voices
@@ -52,11 +55,11 @@ void forbid_parallel_intervals(const Home &home, int size, int nOfVoices, const
  * @param currentPosition the current position in the chord progression
  * @param voice1ID the ID of the first voice
  * @param voice2ID the ID of the second voice
- * @param voicesHarmonicIntervals the array containing the harmonic intervals between adjacent voices
+ * @param voicesIntervalClasses the array containing the classes of the harmonic intervals between the two voices
  * @param FullChordsVoicing the array containing all the notes of the chords in the progression
  */
 void forbid_parallel_interval(Home home, int nVoices, int forbiddenParallelInterval, int currentPosition, int voice1ID,
-                              int voice2ID, IntVarArray voicesHarmonicIntervals, IntVarArray FullChordsVoicing);
+                              int voice2ID, IntVarArray voicesIntervalClasses, IntVarArray FullChordsVoicing);
 
 /**
  * Adds the constraint that Soprano, Alto and Tenor must move in contrary motion to the bass
@@ -89,25 +92,26 @@ void contrary_motion_to_bass(const Home& home, int currentPosition, const IntVar
  * @param tenorMelodicIntervals the melodic interval of the tenor between the current position and the next
  * @param altoMelodicIntervals the melodic interval of the alto between the current position and the next
  * @param sopranoMelodicIntervals the melodic interval of the soprano between the current position and the next
- * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  */
 void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tonality *tonality, vector<int> chordDegs,
                         vector<int> chordQuals, vector<int> chordStas, const IntVarArray &bassMelodicIntervals,
                         const IntVarArray &tenorMelodicIntervals, const IntVarArray &altoMelodicIntervals,
-                        const IntVarArray &sopranoMelodicIntervals, IntVarArray fullChordsVoicing);
+                        const IntVarArray &sopranoMelodicIntervals, IntVarArray pitchClasses);
 
 /**
  * Sets the constraint for a fifth degree followed by a sixth degree in fundamental state
  *      the seventh of the scale must rise to the tonic and the other voices are going down (except for the bass)
  * @param home the instance of the problem
+ * @param nVoices the number of voices in the piece
  * @param currentPosition the current position in the chord progression
  * @param tonality the tonality of the piece
- * @param fullChordsVoicing the array containing the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  * @param tenorMelodicInterval the melodic intervals of the tenor
  * @param altoMelodicInterval the melodic intervals of the alto
  * @param sopranoMelodicInterval the melodic intervals of the soprano
  */
-void interrupted_cadence(const Home &home, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void interrupted_cadence(const Home &home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                          const IntVarArray &tenorMelodicInterval, const IntVarArray &altoMelodicInterval,
                          const IntVarArray &sopranoMelodicInterval);
 
@@ -117,13 +121,13 @@ void interrupted_cadence(const Home &home, int currentPosition, Tonality *tonali
  * @param nOfVoices
  * @param currentPosition
  * @param tonality
- * @param fullChordsVoicing
+ * @param pitchClasses
  * @param bassMelodicIntervals
  * @param tenorMelodicIntervals
  * @param altoMelodicIntervals
  * @param sopranoMelodicIntervals
  */
-void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                              const IntVarArray &bassMelodicIntervals, const IntVarArray &tenorMelodicIntervals,
                              const IntVarArray &altoMelodicIntervals, const IntVarArray &sopranoMelodicIntervals);
 
@@ -140,7 +144,7 @@ void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPositio
  ***********************************************************************************************************************/
 
 void species_seventh(const Home &home, int nOfVoices, int currentPosition, Tonality* tonality, vector<int> chordDegrees, vector<int> chordQualities,
-    IntVarArray fullChordsVoicing);
+    IntVarArray pitchClasses);
 
 /**
  * Sets the constraint for a first degree in second inversion followed by a fifth degree (appogiatura)
@@ -148,14 +152,27 @@ void species_seventh(const Home &home, int nOfVoices, int currentPosition, Tonal
  * @param nVoices the number of voices in the piece
  * @param currentPosition the current position in the chord progression
  * @param tonality the tonality of the piece
- * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  * @param bassMelodicInterval the melodic interval of the bass between the current position and the next
  * @param tenorMelodicInterval the melodic interval of the tenor between the current position and the next
  * @param altoMelodicInterval the melodic interval of the alto between the current position and the next
  * @param sopranoMelodicInterval the melodic interval of the soprano between the current position and the next
  */
-void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                               IntVarArray bassMelodicInterval, const IntVarArray& tenorMelodicInterval,
                               const IntVarArray& altoMelodicInterval, const IntVarArray& sopranoMelodicInterval);
 
-#endif
\ No newline at end of file
+/**
+ * Restrains two consecutive chords to the legal transitions between them with a single table constraint, which replaces
+ * all the other voice leading constraints between the two chords
+ * @param home the instance of the problem
+ * @param currentPosition the current position in the chord progression
+ * @param nOfVoices the number of voices
+ * @param FullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param table the legal transitions, in the form [bass, tenor, alto, soprano, nextBass, nextTenor, nextAlto,
+ * nextSoprano] (see VoicingRules::transition_table)
+ */
+void legal_transitions(const Home &home, int currentPosition, int nOfVoices, IntVarArray FullChordsVoicing,
+                       const TupleSet &table);
+
+#endif
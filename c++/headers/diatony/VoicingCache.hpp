@@ -0,0 +1,81 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A process-wide cache of the legal voicings of each chord, so that they are enumerated only once for
+//                each chord signature.
+//
+#ifndef VOICINGCACHE_HPP
+#define VOICINGCACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "../aux/Utilities.hpp"
+
+using namespace std;
+
+/** A voicing packed in 4 bytes: the bass in the lowest byte, then the tenor, the alto and the soprano */
+typedef uint32_t PackedVoicing;
+
+/**
+ * Everything the legal voicings of a chord depend on. The context holds the few facts about the neighbouring chords
+ * that change the doubling rules of the chord (see VoicingRules::doubling_context).
+ */
+struct ChordSignature {
+    int tonic;                                                              // the tonic of the tonality
+    int mode;                                                               // the mode of the tonality
+    int degree;                                                             // the degree of the chord
+    int quality;                                                            // the quality of the chord
+    int state;                                                              // the state of the chord
+    int context;                                                            // the doubling context of the chord
+
+    bool operator<(const ChordSignature &other) const;
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                 VoicingCache class                                                  *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This class stores the legal voicings of each chord signature met so far as packed records. It is shared by all the
+ * problems of the process and all its methods are thread safe. The voicings are never removed, so the references it
+ * returns stay valid until the end of the process.
+ */
+class VoicingCache {
+protected:
+    static std::mutex                                       lock;           // protects the voicings
+    static map<ChordSignature, vector<PackedVoicing>>       voicings;       // the legal voicings of each signature
+
+public:
+    /**
+     * Packs a voicing in 4 bytes
+     * @param voicing a chord in the form [bass, tenor, alto, soprano] with MIDI values in [0,127]
+     * @return the packed voicing
+     */
+    static PackedVoicing pack(const vector<int> &voicing);
+
+    /**
+     * Unpacks a voicing
+     * @param packed a packed voicing
+     * @return the chord in the form [bass, tenor, alto, soprano]
+     */
+    static vector<int> unpack(PackedVoicing packed);
+
+    /**
+     * Returns the legal voicings of a chord signature, enumerating them the first time the signature is met
+     * @param signature the signature of the chord
+     * @param enumerate a function enumerating the legal voicings of the chord
+     * @return the packed legal voicings of the chord, sorted by bass, then tenor, alto and soprano
+     */
+    static const vector<PackedVoicing>& get(const ChordSignature &signature,
+                                            const function<vector<PackedVoicing>()> &enumerate);
+
+    /**
+     * Returns the number of chord signatures in the cache
+     * @return the number of signatures whose voicings have been enumerated
+     */
+    static int get_size();
+};
+
+#endif
@@ -0,0 +1,278 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A class that evaluates the rules of the four voice texture problem on explicit voicings and solves the
+//                problem exactly by dynamic programming over the legal voicings of each chord.
+//
+#ifndef VOICINGRULES_HPP
+#define VOICINGRULES_HPP
+
+#include <array>
+#include <algorithm>
+
+#include "../aux/Utilities.hpp"
+#include "../aux/Tonality.hpp"
+#include "VoicingCache.hpp"
+#include "TransitionTableCache.hpp"
+
+using namespace std;
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ * Every rule of the FourVoiceTexture model relates a chord to itself or to the next chord, except the doubling of     *
+ * first inversion chords which depends on the motion into and out of the chord. This file mirrors those rules on      *
+ * explicit voicings so that the optimal solution can be found by a Viterbi pass over the legal voicings of each       *
+ * chord, with the costs compared in the same lexicographical order as in the constraint model.                        *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+
+/** Number of costs in the lexicographical cost vector of the problem */
+const int N_OF_COSTS = 5;
+
+/** Maximum number of tuples in a table of legal transitions, above which the rules are posted as propagators */
+const int MAX_TRANSITION_TUPLES = 100000;
+
+/**
+ * Bounds on the number of times a note (regardless of its octave) is present in a chord
+ */
+struct NoteOccurrence {
+    int note;       // the note in [0,11]
+    int min;        // the minimum number of occurrences
+    int max;        // the maximum number of occurrences
+};
+
+/**
+ * A melodic rule of the form "if triggerVoice plays note in the current chord, then voice must move by one of the
+ * allowed intervals to the next chord"
+ */
+struct MotionRule {
+    int triggerVoice;               // the voice that is tested
+    int note;                       // the note in [0,11] that triggers the rule
+    int voice;                      // the voice whose melodic interval is restrained
+    unsigned int allowedIntervals;  // bit (interval + PERFECT_OCTAVE) is set if the melodic interval is allowed
+};
+
+/** Doubling rules that depend on something else than the number of occurrences of each note */
+enum conditional_doubling_rules{
+    NO_CONDITIONAL_DOUBLING,        //0
+    DIMINISHED_DOUBLED_THIRD,       //1 if there are 4 different values, the third is doubled
+    INCOMPLETE_DOUBLED_ROOT,        //2 the chord is incomplete if and only if the root is doubled
+    INCOMPLETE_TRIPLED_ROOT,        //3 the chord has less than 3 notes if and only if the root is tripled
+    CONTRARY_MOTION_DOUBLED_THIRD   //4 the third is doubled if and only if the outer voices move stepwise in contrary motion
+};
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                 VoicingRules class                                                  *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+/**
+ * This class precomputes the rules that the FourVoiceTexture model posts for each chord and each pair of consecutive
+ * chords, and evaluates them on voicings given as vectors [bass, tenor, alto, soprano]. It gives the same feasibility
+ * and the same cost vector as the constraint model, which allows solving the problem by dynamic programming.
+ */
+class VoicingRules {
+public:
+    typedef array<int, N_OF_COSTS> LexCost;                                 // a cost vector in lexicographical order
+
+protected:
+    /** ----------------------------------Problem parameters-------------------------------------------------------- **/
+
+    int                         nOfVoices = 4;                              // The number of voices
+    int                         size;                                       // The number of chords
+    Tonality*                   tonality;                                   // The tonality of the piece
+    vector<int>                 chordDegrees;                               // The degrees of the chords
+    vector<int>                 chordQualities;                             // The qualities of the chords
+    vector<int>                 chordStates;                                // The states of the chords
+
+    /** ----------------------------------Rules for each chord------------------------------------------------------ **/
+
+    vector<vector<bool>>        isChordNote;                                // isChordNote[i][n] if n%12 is in chord i
+    vector<int>                 bassNotes;                                  // the note of the bass of each chord
+    vector<int>                 nOfNotesInChord;                            // the number of notes of complete chords
+    vector<int>                 thirdNotes;                                 // the third of each chord
+    vector<int>                 rootNotes;                                  // the root of each chord
+    vector<vector<NoteOccurrence>> noteOccurrences;                         // the doubling rules of each chord
+    vector<int>                 conditionalDoubling;                        // the conditional doubling rule of each chord
+    vector<bool>                isFundStateDiminished;                      // chords counted in the diminished cost
+
+    /** ----------------------------------Rules between chords------------------------------------------------------ **/
+
+    vector<bool>                forbidsParallels;                           // parallel fifths and octaves are forbidden
+    vector<vector<MotionRule>>  motionRules;                                // the conditional melodic rules
+    vector<int>                 preparedSeventh;                            // the seventh that must be prepared or -1
+    vector<bool>                contraryMotionToBass;                       // upper voices move against the bass
+    vector<bool>                appogiaturaApproach;                        // the next chord is an appogiatura
+
+    /** ---------------------------------------------Methods-------------------------------------------------------- **/
+
+    /**
+     * Computes the doubling rules of a chord depending on its state. Mirrors the chord_note_occurrence functions
+     * @param pos the position of the chord in the progression
+     */
+    void set_note_occurrences(int pos);
+
+    /**
+     * Computes the rules between a chord and the next one. Mirrors the melodic constraints posted by FourVoiceTexture
+     * @param pos the position of the first chord in the progression
+     */
+    void set_transition_rules(int pos);
+
+    /**
+     * Enumerates all the voicings of a chord respecting the rules that only involve that chord
+     * @param pos the position of the chord in the progression
+     * @return the packed legal voicings, sorted by bass, then tenor, alto and soprano
+     */
+    vector<PackedVoicing> enumerate_voicings(int pos) const;
+
+    /**
+     * Enumerates all the pairs of legal voicings of a chord and the next one that respect the rules between them
+     * @param pos the position of the first chord in the progression
+     * @return the finalized table of the legal transitions, one tuple of 8 notes per pair of voicings, or a table marked
+     * as too large if there are more than MAX_TRANSITION_TUPLES of them
+     */
+    TransitionTable enumerate_transitions(int pos) const;
+
+public:
+    /**
+     * Constructor
+     * @param s the number of chords in the progression
+     * @param t a pointer to a Tonality object
+     * @param chordDegs the degrees of the chord of the chord progression
+     * @param chordQuals the qualities of the chord of the chord progression
+     * @param chordStas the states of the chord of the chord progression (fundamental, 1st inversion,...)
+     * @return an instance of VoicingRules with the rules of each chord and between each chord precomputed
+     */
+    VoicingRules(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas);
+
+    /**
+     * Returns the number of chords of the problem
+     * @return an integer representing the number of chords of the problem
+     */
+    int get_size() const;
+
+    /**
+     * Returns whether the doubling of a chord depends on the motion of the outer voices into and out of the chord
+     * @param pos the position of the chord in the progression
+     * @return true if the third is doubled exactly when the bass rises and the soprano falls by step around the chord
+     */
+    bool depends_on_contrary_motion(int pos) const;
+
+    /**
+     * Returns the number of times the third of a chord is present in a voicing
+     * @param pos the position of the chord in the progression
+     * @param voicing a chord in the form [bass, tenor, alto, soprano]
+     * @return the number of voices playing the third of the chord
+     */
+    int n_of_thirds(int pos, const vector<int> &voicing) const;
+
+    /**
+     * Checks the rules that only involve a single chord: ranges, order and spacing of the voices, notes of the chord,
+     * bass note and doubling. The doubling rules depending on the surrounding motion are checked by
+     * outer_voices_contrary_step.
+     * @param pos the position of the chord in the progression
+     * @param voicing a chord in the form [bass, tenor, alto, soprano]
+     * @return true if the voicing respects the rules of the chord
+     */
+    bool is_legal_voicing(int pos, const vector<int> &voicing) const;
+
+    /**
+     * Returns the facts about the neighbouring chords that change the doubling rules of a chord
+     * @param pos the position of the chord in the progression
+     * @return a bit set: bit 0 if the chord is a submediant chord in fundamental state following a dominant chord, bit 1
+     * if the chord is in first inversion and is neither the first nor the last chord
+     */
+    int doubling_context(int pos) const;
+
+    /**
+     * Returns the signature of a chord, which identifies its legal voicings in the VoicingCache
+     * @param pos the position of the chord in the progression
+     * @return the signature of the chord
+     */
+    ChordSignature signature(int pos) const;
+
+    /**
+     * Returns all the voicings of a chord respecting the rules that only involve that chord. They are enumerated once
+     * per chord signature and stored in the VoicingCache.
+     * @param pos the position of the chord in the progression
+     * @return the packed legal voicings, sorted by bass, then tenor, alto and soprano
+     */
+    const vector<PackedVoicing>& legal_packed_voicings(int pos) const;
+
+    /**
+     * Returns all the voicings of a chord respecting the rules that only involve that chord
+     * @param pos the position of the chord in the progression
+     * @return a vector containing all the legal voicings in the form [bass, tenor, alto, soprano]
+     */
+    vector<vector<int>> legal_voicings(int pos) const;
+
+    /**
+     * Checks the rules between two consecutive chords: melodic intervals, parallel intervals, tritone resolution,
+     * special cadences and preparation of sevenths
+     * @param pos the position of the first chord in the progression
+     * @param current the voicing of the chord at position pos
+     * @param next the voicing of the chord at position pos+1
+     * @return true if the transition respects the rules
+     */
+    bool is_legal_transition(int pos, const vector<int> &current, const vector<int> &next) const;
+
+    /**
+     * Returns the facts about the chord after a pair of chords that change the rules between them
+     * @param pos the position of the first chord in the progression
+     * @return 1 if the second chord is the appogiatura of a dominant chord, which must be approached by direct or
+     * oblique motion, 0 otherwise
+     */
+    int transition_context(int pos) const;
+
+    /**
+     * Returns the signature of a pair of consecutive chords, which identifies its table in the TransitionTableCache
+     * @param pos the position of the first chord in the progression
+     * @return the signature of the pair of chords
+     */
+    TransitionSignature transition_signature(int pos) const;
+
+    /**
+     * Returns the table of the legal transitions between a chord and the next one: each tuple is a legal voicing of
+     * both chords in the form [bass, tenor, alto, soprano, nextBass, nextTenor, nextAlto, nextSoprano] that respects
+     * the rules between them. The tables are enumerated once per pair of chord signatures and stored in the
+     * TransitionTableCache.
+     * @param pos the position of the first chord in the progression
+     * @return the legal transitions, marked as too large if the table has more than MAX_TRANSITION_TUPLES tuples
+     */
+    const TransitionTable& transition_table(int pos) const;
+
+    /**
+     * Returns whether the bass rises by step and the soprano falls by step between two chords
+     * @param current the voicing of the first chord
+     * @param next the voicing of the second chord
+     * @return true if the outer voices move by step in contrary motion, the bass going up
+     */
+    bool outer_voices_contrary_step(const vector<int> &current, const vector<int> &next) const;
+
+    /**
+     * Returns the part of the cost vector that depends on a single chord
+     * @param pos the position of the chord in the progression
+     * @param voicing a chord in the form [bass, tenor, alto, soprano]
+     * @return the cost vector of the chord in lexicographical order
+     */
+    LexCost voicing_cost(int pos, const vector<int> &voicing) const;
+
+    /**
+     * Returns the part of the cost vector that depends on the melodic intervals between two chords
+     * @param current the voicing of the first chord
+     * @param next the voicing of the second chord
+     * @return the cost vector of the transition in lexicographical order
+     */
+    LexCost transition_cost(const vector<int> &current, const vector<int> &next) const;
+
+    /**
+     * Finds an optimal voicing for the whole progression by dynamic programming. The states of the Viterbi pass are
+     * the legal voicings of each chord, together with whether the outer voices moved by step in contrary motion into
+     * that chord when its doubling depends on it.
+     * @param costs filled with the cost vector of the optimal solution in lexicographical order
+     * @return the notes of all the chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...], or an empty vector
+     * if the problem has no solution
+     */
+    vector<int> optimal_voicing(vector<int> &costs) const;
+};
+
+#endif
@@ -5,48 +5,43 @@
 #include "../../headers/aux/MajorTonality.hpp"
 
 /**
- * Constructor
+ * Get the table of a major key. The tables of the 12 major keys are built the first time this function is called
  * @param t the tonic of the tonality
+ * @return the table of the key
  */
-MajorTonality::MajorTonality(int t) : Tonality(t, MAJOR_MODE, MAJOR_SCALE){ // calls super() constructor
-    /// set the default chord qualities for each degree
-    chord_qualities[FIRST_DEGREE]               = MAJOR_CHORD;
-    chord_qualities[SECOND_DEGREE]              = MINOR_CHORD;
-    chord_qualities[THIRD_DEGREE]               = MINOR_CHORD;
-    chord_qualities[FOURTH_DEGREE]              = MAJOR_CHORD;
-    chord_qualities[FIFTH_DEGREE]               = MAJOR_CHORD;
-    chord_qualities[SIXTH_DEGREE]               = MINOR_CHORD;
-    chord_qualities[SEVENTH_DEGREE]             = DIMINISHED_CHORD;
-    chord_qualities[FIFTH_DEGREE_APPOGIATURA]   = MAJOR_CHORD;
-    /// chromatic chords
-    chord_qualities[FIVE_OF_TWO]                = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FIVE_OF_THREE]              = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FIVE_OF_FOUR]               = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FIVE_OF_FIVE]               = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FIVE_OF_SIX]                = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FIVE_OF_SEVEN]              = DOMINANT_SEVENTH_CHORD;
-    chord_qualities[FLAT_TWO]                   = MAJOR_CHORD;
-    chord_qualities[AUGMENTED_SIXTH]            = AUGMENTED_SIXTH_CHORD;
+const TonalityTable& MajorTonality::table_of(int t) {
+    /// the initialization of a static local variable is thread safe, and the tables are never modified afterwards
+    static const vector<TonalityTable> tables = []() {
+        array<int, N_OF_DEGREES> qualities;
+        /// set the default chord qualities for each degree
+        qualities[FIRST_DEGREE]                     = MAJOR_CHORD;
+        qualities[SECOND_DEGREE]                    = MINOR_CHORD;
+        qualities[THIRD_DEGREE]                     = MINOR_CHORD;
+        qualities[FOURTH_DEGREE]                    = MAJOR_CHORD;
+        qualities[FIFTH_DEGREE]                     = MAJOR_CHORD;
+        qualities[SIXTH_DEGREE]                     = MINOR_CHORD;
+        qualities[SEVENTH_DEGREE]                   = DIMINISHED_CHORD;
+        qualities[FIFTH_DEGREE_APPOGIATURA]         = MAJOR_CHORD;
+        /// chromatic chords
+        qualities[FIVE_OF_TWO]                      = DOMINANT_SEVENTH_CHORD;
+        qualities[FIVE_OF_THREE]                    = DOMINANT_SEVENTH_CHORD;
+        qualities[FIVE_OF_FOUR]                     = DOMINANT_SEVENTH_CHORD;
+        qualities[FIVE_OF_FIVE]                     = DOMINANT_SEVENTH_CHORD;
+        qualities[FIVE_OF_SIX]                      = DOMINANT_SEVENTH_CHORD;
+        qualities[FIVE_OF_SEVEN]                    = DOMINANT_SEVENTH_CHORD;
+        qualities[FLAT_TWO]                         = MAJOR_CHORD;
+        qualities[AUGMENTED_SIXTH]                  = AUGMENTED_SIXTH_CHORD;
 
-    for (int i = 0; i < chord_qualities.size(); i++){
-        //IntSet set(get_all_notes_from_chord(degrees_notes[i], chord_qualities[i]));
-        //scale_degrees_chords[i] = set;
-    }
+        vector<TonalityTable> keys;
+        for(int tonic = 0; tonic < PERFECT_OCTAVE; tonic++)
+            keys.push_back(build_table(tonic, MAJOR_MODE, MAJOR_SCALE, qualities));
+        return keys;
+    }();
+    return tables[t % PERFECT_OCTAVE];
 }
 
 /**
- * Get the chord quality for each degree
- * @return a map of [degree, chord_quality] for each degree of the scale (0 to 6)
- */
-int MajorTonality:: get_chord_quality(int degree){
-    return chord_qualities[degree];
-}
-
-/**
- * Get the chord notes for a given degree
- * @param degree a degree of the scale [0,6]
- * @return an IntSet containing the chord notes for the given degree
+ * Constructor
+ * @param t the tonic of the tonality
  */
-IntSet MajorTonality::get_scale_degree_chord(int degree){
-    return scale_degrees_chords[degree];
-}
\ No newline at end of file
+MajorTonality::MajorTonality(int t) : Tonality(table_of(t)){}
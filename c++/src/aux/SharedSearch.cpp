@@ -0,0 +1,291 @@
+// Author: Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description: Classes allowing several search engines running in parallel threads to share information
+//
+#include <algorithm>
+#include <cmath>
+
+#include "../../headers/aux/SharedSearch.hpp"
+
+/***********************************************************************************************************************
+ *                                               SharedLexBound class methods                                          *
+ ***********************************************************************************************************************/
+
+/**
+ * Updates the bound if the given cost vector is lexicographically smaller than the current one
+ * @param costs a cost vector in lexicographical order
+ * @return true if the bound was improved
+ */
+bool SharedLexBound::update(const vector<int> &costs) {
+    std::lock_guard<std::mutex> guard(lock);
+    if(found && !(costs < bestCosts))
+        return false;
+    bestCosts = costs;
+    found = true;
+    return true;
+}
+
+/**
+ * Returns the best cost vector found so far
+ * @param costs filled with the best cost vector found so far if there is one
+ * @return true if a solution has been found by one of the engines
+ */
+bool SharedLexBound::get(vector<int> &costs) const {
+    std::lock_guard<std::mutex> guard(lock);
+    if(found)
+        costs = bestCosts;
+    return found;
+}
+
+/***********************************************************************************************************************
+ *                                              SolutionArchive class methods                                          *
+ ***********************************************************************************************************************/
+
+/**
+ * Constructor
+ * @param capacity the maximum number of solutions kept
+ * @param margin the percentage of deviation from the costs of the best solution allowed for the other solutions
+ */
+SolutionArchive::SolutionArchive(int capacity, double margin) : capacity(max(1, capacity)), margin(margin) {}
+
+/**
+ * Returns whether a cost vector is within a margin of a reference cost vector. Each cost must be within the margin
+ * of the reference cost, and the last cost, which is negative, must not be more than the margin worse.
+ * @param costs a cost vector
+ * @param reference the reference cost vector
+ * @param margin the percentage of deviation allowed
+ * @return true if the costs are within the margin of the reference
+ */
+bool SolutionArchive::within_margin(const vector<int> &costs, const vector<int> &reference, double margin) {
+    int last = reference.size() - 1;
+    for(int i = 0; i < last; i++)
+        if(costs[i] < floor(reference[i] * (1.0 - margin)) || costs[i] > ceil(reference[i] * (1.0 + margin)))
+            return false;
+    return costs[last] <= ceil(reference[last] * (1.0 - margin));
+}
+
+/**
+ * Adds a solution if it is not already in the archive and is within the margin of the best solution. A new best
+ * solution removes the archived solutions that are no longer within its margin, and the worst solution is removed if
+ * the archive is full. The margin is checked before the solutions are ranked, so that the archive never keeps a
+ * solution outside of the margin in place of one within it.
+ * @param costs the cost vector of the solution
+ * @param voicing the notes of the solution
+ * @param removed if not nullptr, filled with the voicings of the solutions removed from the archive
+ * @return true if the solution is kept
+ */
+bool SolutionArchive::add(const vector<int> &costs, const vector<int> &voicing, vector<vector<int>>* removed) {
+    std::lock_guard<std::mutex> guard(lock);
+    for(const auto &solution : solutions)
+        if(solution.second == voicing)
+            return false;
+    if(!solutions.empty() && !(costs < solutions.front().first) &&
+       !within_margin(costs, solutions.front().first, margin))
+        return false;
+    if(solutions.size() == capacity && !(costs < solutions.back().first))
+        return false;
+    auto position = upper_bound(solutions.begin(), solutions.end(), make_pair(costs, voicing));
+    solutions.insert(position, make_pair(costs, voicing));
+    /// the new best solution moves the margin: the solutions outside of it are removed
+    if(solutions.front().second == voicing){
+        auto outside = stable_partition(solutions.begin(), solutions.end(),
+                                        [&costs, this](const pair<vector<int>, vector<int>> &solution){
+                                            return within_margin(solution.first, costs, margin);
+                                        });
+        if(removed != nullptr)
+            for(auto it = outside; it != solutions.end(); ++it)
+                removed->push_back(it->second);
+        solutions.erase(outside, solutions.end());
+    }
+    if(solutions.size() > capacity){
+        if(removed != nullptr)
+            removed->push_back(solutions.back().second);
+        solutions.pop_back();
+    }
+    return true;
+}
+
+/**
+ * Returns the cost vector that a new solution has to improve on
+ * @param costs filled with the cost vector of the worst archived solution if the archive is full
+ * @return true if the archive is full
+ */
+bool SolutionArchive::worst(vector<int> &costs) const {
+    std::lock_guard<std::mutex> guard(lock);
+    if(solutions.size() < capacity)
+        return false;
+    costs = solutions.back().first;
+    return true;
+}
+
+/**
+ * Returns the cost vector of the best archived solution
+ * @param costs filled with the cost vector of the best solution if there is one
+ * @return true if the archive is not empty
+ */
+bool SolutionArchive::best(vector<int> &costs) const {
+    std::lock_guard<std::mutex> guard(lock);
+    if(solutions.empty())
+        return false;
+    costs = solutions.front().first;
+    return true;
+}
+
+/**
+ * Returns the maximum value of the first cost for a solution to be within the margin of a better solution. Since the
+ * costs are minimized in lexicographical order, the first cost of the optimal solution is at most the one of the best
+ * solution found so far, so this bound never removes a solution within the margin of the optimal one.
+ * @param bound filled with the bound if the archive is not empty
+ * @return true if the archive is not empty
+ */
+bool SolutionArchive::first_cost_bound(int &bound) const {
+    std::lock_guard<std::mutex> guard(lock);
+    if(solutions.empty())
+        return false;
+    bound = ceil(solutions.front().first[0] * (1.0 + margin));
+    return true;
+}
+
+/**
+ * Returns the archived solutions, which are all within the margin of the best one
+ * @return (costs, voicing) pairs, best first
+ */
+vector<pair<vector<int>, vector<int>>> SolutionArchive::get_solutions() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return solutions;
+}
+
+/***********************************************************************************************************************
+ *                                                 SharedStop class methods                                            *
+ ***********************************************************************************************************************/
+
+/**
+ * Constructor
+ * @param timeLimit the time limit in milliseconds
+ */
+SharedStop::SharedStop(double timeLimit) : stopRequested(false), timeStop(timeLimit) {}
+
+/**
+ * Asks all the engines using this object to stop
+ */
+void SharedStop::request_stop() {
+    stopRequested = true;
+}
+
+/**
+ * Returns whether the search must stop
+ * @param s the statistics of the engine
+ * @param o the options of the engine
+ * @return true if the time limit is reached or if a stop was requested
+ */
+bool SharedStop::stop(const Search::Statistics &s, const Search::Options &o) {
+    return stopRequested || timeStop.stop(s, o);
+}
+
+/***********************************************************************************************************************
+ *                                             CancellationToken class methods                                         *
+ ***********************************************************************************************************************/
+
+CancellationToken::CancellationToken() : cancelled(false), paused(false) {}
+
+/**
+ * Cancels the search. A cancelled search cannot be resumed
+ */
+void CancellationToken::cancel() {
+    {
+        std::lock_guard<std::mutex> guard(lock);    /// so that a waiting thread cannot miss the notification
+        cancelled = true;
+    }
+    changed.notify_all();
+}
+
+/**
+ * Pauses the search. It stops at the next node and waits until it is resumed
+ */
+void CancellationToken::pause() {
+    paused = true;
+}
+
+/**
+ * Resumes a paused search
+ */
+void CancellationToken::resume() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        paused = false;
+    }
+    changed.notify_all();
+}
+
+/**
+ * Returns whether the search is cancelled
+ * @return true if the search is cancelled
+ */
+bool CancellationToken::is_cancelled() const {
+    return cancelled;
+}
+
+/**
+ * Returns whether the search is paused
+ * @return true if the search is paused
+ */
+bool CancellationToken::is_paused() const {
+    return paused;
+}
+
+/**
+ * Blocks the calling thread while the search is paused
+ * @return true if the search can go on, false if it was cancelled
+ */
+bool CancellationToken::wait_while_paused() {
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [this](){ return cancelled || !paused; });
+    return !cancelled;
+}
+
+/***********************************************************************************************************************
+ *                                              CancellableStop class methods                                          *
+ ***********************************************************************************************************************/
+
+/**
+ * Constructor
+ * @param timeLimit the time limit in milliseconds
+ * @param token the token of the search, nullptr if the search can only be stopped by the time limit
+ */
+CancellableStop::CancellableStop(double timeLimit, CancellationToken* token) :
+        token(token), timeLimit(timeLimit), used(0), since(std::chrono::high_resolution_clock::now()) {}
+
+/**
+ * Stops the clock while the search is paused
+ */
+void CancellableStop::suspend() {
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - since;
+    used += duration.count();
+}
+
+/**
+ * Restarts the clock when the search is resumed
+ */
+void CancellableStop::resume() {
+    since = std::chrono::high_resolution_clock::now();
+}
+
+/**
+ * Returns whether the search must stop. If the token is paused, blocks until it is resumed or cancelled. The engine
+ * only sees the answer given once the pause is over: a stopped RBS engine does not restart, so a pause reported as a
+ * stop would end the search for good.
+ * @param s the statistics of the engine
+ * @param o the options of the engine
+ * @return true if the time limit is reached or if the token is cancelled
+ */
+bool CancellableStop::stop(const Search::Statistics &s, const Search::Options &o) {
+    if(token != nullptr && token->is_paused()){
+        suspend();
+        token->wait_while_paused();
+        resume();
+    }
+    if(token != nullptr && token->is_cancelled())
+        return true;
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - since;
+    return used + duration.count() >= timeLimit;
+}
@@ -11,48 +11,69 @@
 
 /**
  * Constructor
- * Creates a tonality object based on the tonality (tonic and mode)
+ * Creates a view on the table of a key. Only the child classes, which own the tables of their mode, can call it
+ * @param t the table of the key
+ */
+Tonality::Tonality(const TonalityTable &t) : table(&t) {}
+
+/**
+ * Computes the table of a key
  * @param t the tonic of the tonality
  * @param m the mode of the tonality
  * @param s the scale of the tonality
+ * @param qualities the default chord quality of each degree
+ * @return the table of the key
  */
-Tonality::Tonality(int t, int m, vector<int> s) {
-    tonic = t % PERFECT_OCTAVE;    // bring it back to [0,11]
-    mode = m;
-    scale = s;
-    name = noteNames[tonic] + " " + modeNames[mode];
-
+TonalityTable Tonality::build_table(int t, int m, const vector<int> &s, const array<int, N_OF_DEGREES> &qualities) {
+    TonalityTable table;
+    int tonic = t % PERFECT_OCTAVE;    // bring it back to [0,11]
+    table.tonic = tonic;
+    table.mode = m;
+    table.scale = &s;
+    table.name = noteNames[tonic] + " " + modeNames[m];
+    table.chordQualities = qualities;
+
+    auto &degrees_notes = table.degreesNotes;
     int note = tonic;
     degrees_notes[FIRST_DEGREE]                 = note;
     degrees_notes[FIVE_OF_FOUR]                 = note;
     degrees_notes[FIFTH_DEGREE_APPOGIATURA]     = note;
     degrees_notes[FLAT_TWO]                     = (note + MINOR_SECOND)              % PERFECT_OCTAVE;
-    degrees_notes[SECOND_DEGREE]                = (note += scale[FIRST_DEGREE])      % PERFECT_OCTAVE;
+    degrees_notes[SECOND_DEGREE]                = (note += s[FIRST_DEGREE])          % PERFECT_OCTAVE;
     degrees_notes[FIVE_OF_FIVE]                 = note                               % PERFECT_OCTAVE;
-    degrees_notes[THIRD_DEGREE]                 = (note += scale[SECOND_DEGREE])     % PERFECT_OCTAVE;
+    degrees_notes[THIRD_DEGREE]                 = (note += s[SECOND_DEGREE])         % PERFECT_OCTAVE;
     degrees_notes[FIVE_OF_SIX]                  = note                               % PERFECT_OCTAVE;
-    degrees_notes[FOURTH_DEGREE]                = (note += scale[THIRD_DEGREE])      % PERFECT_OCTAVE;
+    degrees_notes[FOURTH_DEGREE]                = (note += s[THIRD_DEGREE])          % PERFECT_OCTAVE;
     degrees_notes[FIVE_OF_SEVEN]                = note                               % PERFECT_OCTAVE;
-    degrees_notes[FIFTH_DEGREE]                 = (note += scale[FOURTH_DEGREE])     % PERFECT_OCTAVE;
-    degrees_notes[SIXTH_DEGREE]                 = (note += scale[FIFTH_DEGREE])      % PERFECT_OCTAVE;
+    degrees_notes[FIFTH_DEGREE]                 = (note += s[FOURTH_DEGREE])         % PERFECT_OCTAVE;
+    degrees_notes[SIXTH_DEGREE]                 = (note += s[FIFTH_DEGREE])          % PERFECT_OCTAVE;
     degrees_notes[FIVE_OF_TWO]                  = note                               % PERFECT_OCTAVE;
-    degrees_notes[SEVENTH_DEGREE]               = (note += scale[SIXTH_DEGREE])      % PERFECT_OCTAVE;
+    degrees_notes[SEVENTH_DEGREE]               = (note += s[SIXTH_DEGREE])          % PERFECT_OCTAVE;
     if (m == MINOR_MODE)    degrees_notes[FIVE_OF_THREE] = (note - 1)                % PERFECT_OCTAVE;
     else                    degrees_notes[FIVE_OF_THREE] = note                      % PERFECT_OCTAVE;
     degrees_notes[AUGMENTED_SIXTH]              = (tonic + MINOR_SIXTH)              % PERFECT_OCTAVE;
 
-    tonal_notes = {degrees_notes[FIRST_DEGREE], degrees_notes[FOURTH_DEGREE], degrees_notes[FIFTH_DEGREE]};
+    for(int degree = FIRST_DEGREE; degree < N_OF_DEGREES; degree++){
+        table.scaleDegrees[degree] = get_all_given_note_set(degrees_notes[degree]);
+        table.scaleDegreesChords[degree] = get_all_notes_in_chord_set(degrees_notes[degree], qualities[degree]);
+    }
+
+    table.tonalNotes = {degrees_notes[FIRST_DEGREE], degrees_notes[FOURTH_DEGREE], degrees_notes[FIFTH_DEGREE]};
     /// Modal notes are the notes that change in major or minor scale (3,6,7 degrees). For simplicity for constraints,
     /// All notes that are not tonal are considered modal (useful for doubling)
     for(int i = 0; i < PERFECT_OCTAVE; i++){
-        if(tonal_notes.find(i) == tonal_notes.end())
-            modal_notes.insert(i);
+        if(table.tonalNotes.find(i) == table.tonalNotes.end())
+            table.modalNotes.insert(i);
     }
-    /// The rest of the attributes are set by the child classes
+    return table;
 }
 
-string Tonality::get_name() const {
-    return name;
+/**
+ * Get the name of the tonality
+ * @return a string containing the name of the tonality
+ */
+const string& Tonality::get_name() const {
+    return table->name;
 }
 
 /**
@@ -60,7 +81,7 @@ string Tonality::get_name() const {
  * @return the tonic of the tonality
  */
 int Tonality::get_tonic() const {
-    return tonic;
+    return table->tonic;
 }
 
 /**
@@ -68,68 +89,97 @@ int Tonality::get_tonic() const {
  * @return the mode of the tonality
  */
 int Tonality::get_mode() const{
-    return mode;
+    return table->mode;
 }
 
 /**
  * Get the scale of the tonality
  * @return the scale of the tonality
  */
-vector<int> Tonality::get_scale() {
-    return scale;
+const vector<int>& Tonality::get_scale() const {
+    return *table->scale;
+}
+
+/**
+ * Get the notes corresponding to the degrees of the scale on which chords are built
+ * @return the notes for each of the degrees
+ */
+const array<int, N_OF_DEGREES>& Tonality::get_degrees_notes() const {
+    return table->degreesNotes;
 }
 
 /**
  * Get the note on which the chord is built for a given degree
- * @param degree the degree of the scale [0,6]
+ * @param degree a degree [0,15] (see the degrees enum)
  * @return the note for the given degree
+ * @throws std::out_of_range if the degree does not exist
  */
-int Tonality::get_degree_note(int degree){
-    return degrees_notes[degree];
+int Tonality::get_degree_note(int degree) const {
+    return table->degreesNotes.at(degree);
 }
 
 /**
  * Get all the notes for each scale degree
- * @return a map of [degree, all_notes] for each degree of the scale (0 to 6)
+ * @return the notes [0,127] of each degree
  */
-map<int, IntSet> Tonality::get_scale_degrees() {
-    return scale_degrees;
+const array<IntSet, N_OF_DEGREES>& Tonality::get_scale_degrees() const {
+    return table->scaleDegrees;
 }
 
 /**
  * Get all the notes for a given scale degree
- * @param degree a degree of the scale [0,6]
+ * @param degree a degree [0,15] (see the degrees enum)
  * @return an IntSet containing all the notes for the given scale degree
  */
-IntSet Tonality::get_scale_degree(int degree) {
-    return scale_degrees[degree];
+const IntSet& Tonality::get_scale_degree(int degree) const {
+    return table->scaleDegrees.at(degree);
 }
 
 /**
  * Get the notes that don't change in major or minor scale (1,4,5 degrees)
- * @return an IntSet containing the tonal notes
+ * @return the tonal notes
  */
-set<int> Tonality::get_tonal_notes() {
-    return tonal_notes;
+const set<int>& Tonality::get_tonal_notes() const {
+    return table->tonalNotes;
 }
 
 /**
  * Get the notes that change in major or minor scale (3,6,7 degrees)
- * @return an IntSet containing the modal notes
+ * @return the modal notes
+ */
+const set<int>& Tonality::get_modal_notes() const {
+    return table->modalNotes;
+}
+
+/**
+ * Get the chord quality for each degree
+ * @param degree a degree [0,15] (see the degrees enum)
+ * @return the default chord quality for the given degree
+ */
+int Tonality::get_chord_quality(int degree) const {
+    return table->chordQualities.at(degree);
+}
+
+/**
+ * Get the chord notes for a given degree
+ * @param degree a degree [0,15] (see the degrees enum)
+ * @return an IntSet containing the notes [0,127] of the default chord of the given degree
  */
-set<int> Tonality::get_modal_notes() {
-    return modal_notes;
+const IntSet& Tonality::get_scale_degree_chord(int degree) const {
+    return table->scaleDegreesChords.at(degree);
 }
 
 /**
  * @return a string representing a tonality
  */
-string Tonality::to_string() {
+string Tonality::to_string() const {
+    const auto &chord_qualities = table->chordQualities;
+    const auto &degrees_notes = table->degreesNotes;
     string t;
-    t += "Name: " + name + "\n";
-    t += "Tonic: " + std::to_string(tonic) + "(" + noteNames[tonic] + ")\n";
-    t += "Mode: " + std::to_string(mode) + "(" + modeNames[mode] + ")\n";
-    t += "Scale: " + int_vector_to_string(scale) + "\n";
+    t += "Name: " + table->name + "\n";
+    t += "Tonic: " + std::to_string(table->tonic) + "(" + noteNames[table->tonic] + ")\n";
+    t += "Mode: " + std::to_string(table->mode) + "(" + modeNames[table->mode] + ")\n";
+    t += "Scale: " + int_vector_to_string(*table->scale) + "\n";
 
     t+= "Default chord qualities: ";
     for(int i = FIRST_DEGREE; i <= AUGMENTED_SIXTH; i++)
@@ -142,15 +192,17 @@ string Tonality::to_string() {
     t += "\n";
 
     t += "Tonal notes: ";
-    for (auto elem: tonal_notes)
+    for (auto elem: table->tonalNotes)
         t += std::to_string(elem) + " ";
 
     return t;
 }
 
-string Tonality::pretty() {
+string Tonality::pretty() const {
+    const auto &chord_qualities = table->chordQualities;
+    const auto &degrees_notes = table->degreesNotes;
     string t;
-    t += "Name: " + name + "\n";
+    t += "Name: " + table->name + "\n";
 
     t+= "Default chord qualities: ";
     for(int i = FIRST_DEGREE; i <= AUGMENTED_SIXTH; i++)
@@ -51,6 +51,44 @@ vector<int> get_all_given_note(int note)
     return notes;
 }
 
+/**
+ * Get all the notes [0,127] of a chord as an IntSet. The sets of the 12 roots and all the qualities are built once, the
+ * first time one of them is needed, and are shared read-only by all the models afterwards
+ * @param root the root of the chord
+ * @param quality the quality of the chord
+ * @return an IntSet containing the same notes as get_all_notes_in_chord
+ */
+const IntSet& get_all_notes_in_chord_set(int root, int quality){
+    /// the initialization of a function-local static is thread-safe, so concurrent models can all call this function
+    static const vector<IntSet> sets = [](){
+        vector<IntSet> s;
+        for(int r = 0; r < PERFECT_OCTAVE; r++)
+            for(int q = 0; q < N_OF_CHORD_QUALITIES; q++)
+                s.push_back(IntSet(get_all_notes_in_chord(r, q)));
+        return s;
+    }();
+    /// the sets of all the roots are in one vector: a quality out of range would silently read the set of another root
+    if(quality < 0 || quality >= N_OF_CHORD_QUALITIES)
+        throw std::invalid_argument("Unknown chord quality");
+    return sets[(root % PERFECT_OCTAVE) * N_OF_CHORD_QUALITIES + quality];
+}
+
+/**
+ * Get all the notes [0,127] of a pitch class as an IntSet. The sets of the 12 pitch classes are built once, the first
+ * time one of them is needed, and are shared read-only by all the models afterwards
+ * @param note a note
+ * @return an IntSet containing the same notes as get_all_given_note
+ */
+const IntSet& get_all_given_note_set(int note){
+    static const vector<IntSet> sets = [](){
+        vector<IntSet> s;
+        for(int n = 0; n < PERFECT_OCTAVE; n++)
+            s.push_back(IntSet(get_all_given_note(n)));
+        return s;
+    }();
+    return sets.at(note % PERFECT_OCTAVE);
+}
+
 /**
  * Get the interval in semitones between the root and
  * @param quality the quality of the chord
@@ -68,6 +106,66 @@ int get_interval_from_root(int quality, int chordNote){
     return diff;
 }
 
+/**
+ * Returns the variable selection of a heuristic. The static orders only depend on the variables, while the learned
+ * heuristics (AFC, action and CHB) gather statistics on the failures during search, which the restarts keep. A new
+ * branching is returned each time, so the statistics are not shared between problems.
+ * @param heuristic a variable selection heuristic (see the variable_selection enum)
+ * @param decay the decay factor in ]0,1] by which the AFC and the action of all the variables are multiplied at each
+ * failure, 1 to keep the whole history. CHB has no decay factor: its step size decreases with the number of failures
+ * @return the variable selection of the heuristic
+ */
+IntVarBranch variable_selection_heuristic(int heuristic, double decay){
+    switch(heuristic){
+        case DEGREE_MAX:
+            return INT_VAR_DEGREE_MAX();
+        case DOM_SIZE_MIN:
+            return INT_VAR_SIZE_MIN();
+        case RIGHT_TO_LEFT:
+            /// go <-- soprano->bass: 4-3-2-1-8-7-6-5 etc
+            return INT_VAR_MERIT_MAX([](const Space& home, IntVar x, int i) -> double {
+                return i;
+            });
+        case LEFT_TO_RIGHT_SOPRANO_TO_BASS:
+            /// go --> soprano->bass
+            return INT_VAR_MERIT_MIN([](const Space& home, IntVar x, int i) -> double {
+                return (i/4) * 4 + (4 - i%4);
+            });
+        case AFC_MAX:
+            return INT_VAR_AFC_MAX(decay);
+        case ACTION_MAX:
+            return INT_VAR_ACTION_MAX(decay);
+        case CHB_MAX:
+            return INT_VAR_CHB_MAX();
+        default:
+            throw std::invalid_argument("Unknown variable selection heuristic");
+    }
+}
+
+/**
+ * Returns the value selection of a heuristic. VAL_CLOSEST_NEIGHBOUR depends on the other notes of the space, so
+ * FourVoiceTexture builds it and it is not returned by this function.
+ * @param heuristic a value selection heuristic (see the value_selection enum) other than VAL_CLOSEST_NEIGHBOUR
+ * @param seed the seed of the random value selection
+ * @return the value selection of the heuristic
+ */
+IntValBranch value_selection_heuristic(int heuristic, unsigned int seed){
+    switch(heuristic){
+        case VAL_MIN:
+            return INT_VAL_MIN();
+        case VAL_MAX:
+            return INT_VAL_MAX();
+        case VAL_MED:
+            return INT_VAL_MED();
+        case VAL_RND:
+            return INT_VAL_RND(Rnd(seed));
+        case VAL_CLOSEST_NEIGHBOUR:
+            throw std::invalid_argument("The closest neighbour value selection is built by FourVoiceTexture");
+        default:
+            throw std::invalid_argument("Unknown value selection heuristic");
+    }
+}
+
 /**
  * Transforms a vector of integers into a string
  * @param vector a vector of integers
@@ -186,6 +284,22 @@ string intVarArgs_to_string(IntVarArgs args){
     return res;
 }
 
+/**
+ * Returns the values of an IntVarArgs as a vector of integers
+ * @param args an IntVarArgs whose variables are all assigned
+ * @return a vector containing the values of the variables
+ */
+vector<int> intVarArgs_to_int_vector(IntVarArgs args) {
+    vector<int> res;
+    for (auto & var : args) {
+        if (!var.assigned()) {
+            throw std::invalid_argument("Variable not assigned");
+        }
+        res.push_back(var.val());
+    }
+    return res;
+}
+
 
 
 /**
@@ -0,0 +1,137 @@
+// Author: Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description: A thread pool in which idle threads steal the tasks queued by the other threads
+//
+#include "../../headers/aux/WorkStealingPool.hpp"
+
+/** The index of the pool thread running the current code, -1 outside of the pools */
+static thread_local int currentWorker = -1;
+/** The pool owning the thread running the current code, nullptr outside of the pools */
+static thread_local const WorkStealingPool* currentPool = nullptr;
+
+/**
+ * Constructor
+ * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+ */
+WorkStealingPool::WorkStealingPool(int nOfThreads) : nOfQueued(0), nextQueue(0), stopping(false), nOfUnfinished(0) {
+    if(nOfThreads <= 0)
+        nOfThreads = max(1, (int) std::thread::hardware_concurrency());
+    for(int i = 0; i < nOfThreads; i++)
+        queues.emplace_back(new TaskQueue());
+    for(int i = 0; i < nOfThreads; i++)
+        workers.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+/**
+ * Destructor. Waits for the threads to finish their current task, the tasks left in the queues are not executed
+ */
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        stopping = true;
+    }
+    idle.notify_all();
+    for(auto &worker : workers)
+        worker.join();
+}
+
+/**
+ * Returns the number of threads of the pool
+ * @return the number of threads
+ */
+int WorkStealingPool::get_size() const {
+    return workers.size();
+}
+
+/**
+ * Adds a task to the pool
+ * @param task the task to execute
+ */
+void WorkStealingPool::submit(function<void()> task) {
+    {
+        std::lock_guard<std::mutex> guard(doneLock);
+        nOfUnfinished++;
+    }
+    int id = currentPool == this ? currentWorker : (int) (nextQueue++ % queues.size());
+    {
+        std::lock_guard<std::mutex> guard(queues[id]->lock);
+        queues[id]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> guard(idleLock);    // so that an idle thread cannot miss the notification
+        nOfQueued++;
+    }
+    idle.notify_one();
+}
+
+/**
+ * Waits until all the submitted tasks are finished. If a task has thrown an exception, it is rethrown here
+ */
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(doneLock);
+    done.wait(lock, [this](){ return nOfUnfinished == 0; });
+    if(error){
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+/**
+ * Takes a task from the queue of a thread, or steals one from the other queues
+ * @param id the index of the thread
+ * @param task filled with the task
+ * @return true if a task was found
+ */
+bool WorkStealingPool::take_task(int id, function<void()> &task) {
+    int n = queues.size();
+    for(int i = 0; i < n; i++){
+        TaskQueue &queue = *queues[(id + i) % n];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if(queue.tasks.empty())
+            continue;
+        if(i == 0){ /// own queue: most recent task
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else{ /// other queue: oldest task
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        nOfQueued--;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * The loop executed by each thread of the pool
+ * @param id the index of the thread
+ */
+void WorkStealingPool::run(int id) {
+    currentWorker = id;
+    currentPool = this;
+    while(true){
+        function<void()> task;
+        if(!take_task(id, task)){
+            std::unique_lock<std::mutex> lock(idleLock);
+            idle.wait(lock, [this](){ return stopping || nOfQueued > 0; });
+            if(stopping)
+                return;
+            continue;
+        }
+        try{
+            task();
+        }
+        catch(...){
+            std::lock_guard<std::mutex> guard(doneLock);
+            if(!error)
+                error = current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> guard(doneLock);
+            if(--nOfUnfinished == 0)
+                done.notify_all();
+        }
+    }
+}
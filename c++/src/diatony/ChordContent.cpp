@@ -0,0 +1,214 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator linking the notes of a chord to their doubling and to the number of different notes
+//
+#include "../../headers/diatony/ChordContent.hpp"
+
+/**
+ * Constructor
+ * @param nOfVoices the number of voices, which bounds the number of occurrences of every note
+ */
+ChordOccurrences::ChordOccurrences(int nOfVoices) {
+    min.fill(0);
+    max.fill(nOfVoices);
+}
+
+/**
+ * Restrains the number of occurrences of a note, as count(home, chord, note, relation, n) would
+ * @param note a note [0,11]
+ * @param relation the relation between the number of occurrences and n (IRT_EQ, IRT_LQ, IRT_LE, IRT_GQ or IRT_GR)
+ * @param n the number of occurrences
+ */
+void ChordOccurrences::restrain(int note, IntRelType relation, int n) {
+    note %= PERFECT_OCTAVE;
+    switch(relation){
+        case IRT_EQ:
+            min[note] = std::max(min[note], n);
+            max[note] = std::min(max[note], n);
+            break;
+        case IRT_LQ:
+            max[note] = std::min(max[note], n);
+            break;
+        case IRT_LE:
+            max[note] = std::min(max[note], n - 1);
+            break;
+        case IRT_GQ:
+            min[note] = std::max(min[note], n);
+            break;
+        case IRT_GR:
+            min[note] = std::max(min[note], n + 1);
+            break;
+        default:
+            throw std::invalid_argument("This relation cannot restrain the occurrences of a note");
+    }
+}
+
+/**
+ * Constructor for posting
+ * @param home the space
+ * @param views the notes of the chord followed by the number of different values and of different notes
+ * @param voices the number of voices
+ * @param occ the bounds on the occurrences of each note
+ */
+ChordContent::ChordContent(Home home, ViewArray<Int::IntView> &views, int voices, const ChordOccurrences &occ) :
+        NaryPropagator<Int::IntView, Int::PC_INT_DOM>(home, views), nOfVoices(voices), occurrences(occ) {}
+
+/**
+ * Constructor for cloning
+ * @param home the space
+ * @param p the propagator to copy
+ */
+ChordContent::ChordContent(Space &home, ChordContent &p) :
+        NaryPropagator<Int::IntView, Int::PC_INT_DOM>(home, p), nOfVoices(p.nOfVoices), occurrences(p.occurrences) {}
+
+/**
+ * Posts the propagator
+ * @param home the space
+ * @param views the notes of the chord followed by the number of different values and of different notes
+ * @param voices the number of voices
+ * @param occ the bounds on the occurrences of each note
+ * @return ES_OK
+ */
+ExecStatus ChordContent::post(Home home, ViewArray<Int::IntView> &views, int voices, const ChordOccurrences &occ) {
+    (void) new (home) ChordContent(home, views, voices, occ);
+    return ES_OK;
+}
+
+/**
+ * Copies the propagator during cloning
+ * @param home the space
+ * @return a copy of the propagator
+ */
+Propagator* ChordContent::copy(Space &home) {
+    return new (home) ChordContent(home, *this);
+}
+
+/**
+ * Returns the cost of the propagator: the enumeration is exponential in the number of voices, which is small
+ * @param home the space
+ * @param med the modification events
+ * @return the cost of the propagator
+ */
+PropCost ChordContent::cost(const Space &home, const ModEventDelta &med) const {
+    return PropCost::quadratic(PropCost::HI, x.size());
+}
+
+/**
+ * Enumerates the voicings whose first notes are given and marks the values they use as supported. A voicing is valid
+ * if its notes are in increasing order, if each note respects its bounds on the occurrences, and if its number of
+ * different values and of different notes are in the domains of the corresponding views.
+ * @param voice the voice to assign next
+ * @param values the values left in the domains of the voices, one voice after the other
+ * @param first the index in values of the first value of each voice, followed by the number of values
+ * @param voicing the index in values of the notes of the voices below voice
+ * @param counts the number of occurrences of each note in voicing
+ * @param supported filled with whether each value in values belongs to a valid voicing, followed by the same for the
+ * numbers of different values and of different notes in [0, nOfVoices]
+ */
+void ChordContent::support(int voice, const int* values, const int* first, int* voicing,
+                           array<int, PERFECT_OCTAVE> &counts, bool* supported) const {
+    /// the notes still missing to reach the minimum occurrences must fit in the remaining voices
+    int missing = 0;
+    for(int note = 0; note < PERFECT_OCTAVE; note++)
+        missing += std::max(0, occurrences.min[note] - counts[note]);
+    if(missing > nOfVoices - voice)
+        return;
+
+    if(voice == nOfVoices){
+        int nOfValues = 0;
+        unsigned int occupied = 0;       /// bit i is set if the note i is in the voicing
+        for(int v = 0; v < nOfVoices; v++){
+            int value = values[voicing[v]];
+            /// the voicing is in increasing order, so equal values are next to each other
+            if(v == 0 || value != values[voicing[v - 1]])
+                nOfValues++;
+            occupied |= 1U << (value % PERFECT_OCTAVE);
+        }
+        int nOfNotes = 0;
+        for(; occupied != 0; occupied &= occupied - 1)
+            nOfNotes++;
+        if(!x[nOfVoices].in(nOfValues) || !x[nOfVoices + 1].in(nOfNotes))
+            return;
+        for(int v = 0; v < nOfVoices; v++)
+            supported[voicing[v]] = true;
+        supported[first[nOfVoices] + nOfValues] = true;
+        supported[first[nOfVoices] + nOfVoices + 1 + nOfNotes] = true;
+        return;
+    }
+
+    for(int k = first[voice]; k < first[voice + 1]; k++){
+        int value = values[k];
+        if(voice > 0 && value < values[voicing[voice - 1]])
+            continue;
+        int note = value % PERFECT_OCTAVE;
+        if(counts[note] == occurrences.max[note])
+            continue;
+        counts[note]++;
+        voicing[voice] = k;
+        support(voice + 1, values, first, voicing, counts, supported);
+        counts[note]--;
+    }
+}
+
+/**
+ * Removes the values that belong to no valid voicing of the chord. Every value left belongs to a valid voicing made of
+ * values that are left too, so the propagator is idempotent.
+ * @param home the space
+ * @param med the modification events
+ * @return the status of the propagation
+ */
+ExecStatus ChordContent::propagate(Space &home, const ModEventDelta &med) {
+    /// the propagator runs at every node, so its buffers are taken from the region of the space rather than the heap
+    Region r;
+    int* first = r.alloc<int>(nOfVoices + 1);
+    first[0] = 0;
+    for(int v = 0; v < nOfVoices; v++)
+        first[v + 1] = first[v] + x[v].size();
+    int* values = r.alloc<int>(first[nOfVoices]);
+    for(int v = 0; v < nOfVoices; v++){
+        int k = first[v];
+        for(Int::ViewValues<Int::IntView> i(x[v]); i(); ++i)
+            values[k++] = i.val();
+    }
+    /// the numbers of different values and of different notes are both in [0, nOfVoices]
+    int nOfSupports = first[nOfVoices] + 2 * (nOfVoices + 1);
+    bool* supported = r.alloc<bool>(nOfSupports);
+    for(int k = 0; k < nOfSupports; k++)
+        supported[k] = false;
+
+    int* voicing = r.alloc<int>(nOfVoices);
+    array<int, PERFECT_OCTAVE> counts;
+    counts.fill(0);
+    support(0, values, first, voicing, counts, supported);
+
+    for(int v = 0; v < nOfVoices; v++)
+        for(int k = first[v]; k < first[v + 1]; k++)
+            if(!supported[k])
+                GECODE_ME_CHECK(x[v].nq(home, values[k]));
+    /// the numbers of different values and of different notes
+    for(int v = nOfVoices; v < nOfVoices + 2; v++){
+        const bool* supportedCounts = supported + first[nOfVoices] + (v - nOfVoices) * (nOfVoices + 1);
+        for(int n = x[v].min(); n <= x[v].max(); n++)
+            if(x[v].in(n) && (n < 0 || n > nOfVoices || !supportedCounts[n]))
+                GECODE_ME_CHECK(x[v].nq(home, n));
+    }
+    return x.assigned() ? home.ES_SUBSUMED(*this) : ES_FIX;
+}
+
+/**
+ * Links the notes of a chord to the number of different values and of different notes (regardless of their octave) in
+ * the chord, and enforces the bounds on the occurrences of each note, with a single ChordContent propagator
+ * @param home the instance of the problem
+ * @param currentChord the notes of the chord in the form [bass, tenor, alto, soprano]
+ * @param occurrences the bounds on the occurrences of each note
+ * @param nOfValues the number of different values in the chord
+ * @param nOfNotes the number of different notes in the chord
+ */
+void chord_content(Home home, const IntVarArgs &currentChord, const ChordOccurrences &occurrences,
+                   const IntVar &nOfValues, const IntVar &nOfNotes) {
+    GECODE_POST;
+    IntVarArgs notes(currentChord);
+    notes << nOfValues << nOfNotes;
+    ViewArray<Int::IntView> views(home, notes);
+    GECODE_ES_FAIL(ChordContent::post(home, views, currentChord.size(), occurrences));
+}
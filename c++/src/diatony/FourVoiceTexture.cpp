@@ -2,6 +2,8 @@
 // Creation Date: Jan 20 2023
 // Description:   A class that creates a constraint representation of a four voice harmonic problem of tonal music.
 //
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 #include "../../headers/diatony/FourVoiceTexture.hpp"
@@ -26,41 +28,63 @@
  * @param chordDegs the degrees of the chord of the chord progression
  * @param chordQuals the qualities of the chord of the chord progression
  * @param chordStas the states of the chord of the chord progression (fundamental, 1st inversion,...)
+ * @param options the branching strategy and the bound shared with other engines
  * @return an instance of FourVoiceTexture initialized with the given parameters, constraints and branching strategies
  * posted.
+ * @throws std::invalid_argument if the hint of the options is neither empty nor of size 4 * s
  * /!\ dominant diminished seventh chords are considered as minor ninth dominant chords without their fundamental
  */
-FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas) {
+FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas,
+                                   const FourVoiceTextureOptions &options) {
     //todo: support seventh chords for all chord degrees + diminished seventh chords
     /// Parameters
     size                                            = s;
-    tonality                                        = t;
-    chordDegrees                                    = chordDegs;
-    chordQualities                                  = std::move(chordQuals);
-    chordStates                                     = chordStas;
-    nOfNotesInChord                                 = IntArgs(size);
+    auto descriptor                                 = std::make_shared<ProblemDescriptor>();
+    descriptor->tonality                            = t;
+    descriptor->chordDegrees                        = chordDegs;
+    descriptor->chordQualities                      = std::move(chordQuals);
+    descriptor->chordStates                         = chordStas;
+    descriptor->nOfNotesInChord                     = IntArgs(size);
     /// keep track of the number of notes that should be in each chord if it is complete
     for(int i = 0; i < size; i++)
-        nOfNotesInChord[i] = chordQualitiesIntervals.at(chordQualities[i]).size() + 1;
+        descriptor->nOfNotesInChord[i] = chordQualitiesIntervals.at(descriptor->chordQualities[i]).size() + 1;
+    problem                                         = descriptor;
+    /// short names for the parameters, used to post the constraints
+    Tonality* tonality                              = problem->tonality;
+    const vector<int> &chordDegrees                 = problem->chordDegrees;
+    const vector<int> &chordQualities               = problem->chordQualities;
+    const vector<int> &chordStates                  = problem->chordStates;
+    const IntArgs &nOfNotesInChord                  = problem->nOfNotesInChord;
+
+    sharedBound                                     = options.sharedBound;
+    archive                                         = options.archive;
+    lnsWindow                                       = min(options.lnsWindow, size);
+    lnsNeighbourhood                                = options.lnsNeighbourhood;
+    lnsRnd                                          = Rnd(options.seed);
+    /// the value selections read the hint by the index of the variable, so it must cover all of them
+    if(!options.hint.empty() && (int) options.hint.size() != nOfVoices * size)
+        throw std::invalid_argument("The hint must contain one note per voice for each chord");
 
     /// solution array
     fullChordsVoicing                               = IntVarArray(*this, nOfVoices * size, 0, 127);
 
-    /// variable arrays for melodic intervals for each voice
-    bassMelodicIntervals                            = IntVarArray(*this, size - 1, -PERFECT_OCTAVE, PERFECT_OCTAVE);
-    tenorMelodicIntervals                           = IntVarArray(*this, size - 1, -PERFECT_OCTAVE, PERFECT_OCTAVE);
-    altoMelodicIntervals                            = IntVarArray(*this, size - 1, -PERFECT_OCTAVE, PERFECT_OCTAVE);
-    sopranoMelodicIntervals                         = IntVarArray(*this, size - 1, -PERFECT_OCTAVE, PERFECT_OCTAVE);
-
+    /// variable array for the melodic intervals of all voices
     allMelodicIntervals                             = IntVarArray(*this, nOfVoices* (size - 1), -PERFECT_OCTAVE, PERFECT_OCTAVE);
 
-    /// variable arrays for harmonic intervals between adjacent voices (only positive because there is no direction)
-    bassTenorHarmonicIntervals                      = IntVarArray(*this, size, 0, PERFECT_OCTAVE + PERFECT_FIFTH);
-    bassAltoHarmonicIntervals                       = IntVarArray(*this, size, 0, 2 * PERFECT_OCTAVE + PERFECT_FIFTH);
-    bassSopranoHarmonicIntervals                    = IntVarArray(*this, size, 0, 3 * PERFECT_OCTAVE + PERFECT_FIFTH);
-    tenorAltoHarmonicIntervals                      = IntVarArray(*this, size, 0, PERFECT_OCTAVE);
-    tenorSopranoHarmonicIntervals                   = IntVarArray(*this, size, 0, 2 * PERFECT_OCTAVE);
-    altoSopranoHarmonicIntervals                    = IntVarArray(*this, size, 0, PERFECT_OCTAVE);
+    /// variable array for harmonic intervals between adjacent voices (only positive because there is no direction)
+    IntVarArgs harmonicIntervalsArgs;
+    for(int i = 0; i < size; i++){
+        harmonicIntervalsArgs << IntVar(*this, 0, PERFECT_OCTAVE + PERFECT_FIFTH);     /// bass - tenor
+        harmonicIntervalsArgs << IntVar(*this, 0, PERFECT_OCTAVE);                     /// tenor - alto
+        harmonicIntervalsArgs << IntVar(*this, 0, PERFECT_OCTAVE);                     /// alto - soprano
+    }
+    harmonicIntervals                               = IntVarArray(*this, harmonicIntervalsArgs);
+
+    /// the intervals of each voice are views on the array above, not variables
+    IntVarArray bassMelodicIntervals(*this, allMelodicIntervals.slice(BASS, nOfVoices, size - 1));
+    IntVarArray tenorMelodicIntervals(*this, allMelodicIntervals.slice(TENOR, nOfVoices, size - 1));
+    IntVarArray altoMelodicIntervals(*this, allMelodicIntervals.slice(ALTO, nOfVoices, size - 1));
+    IntVarArray sopranoMelodicIntervals(*this, allMelodicIntervals.slice(SOPRANO, nOfVoices, size - 1));
 
     /// cost variables auxiliary arrays
     nDifferentValuesInDiminishedChord               = IntVarArray(*this, size, 0, nOfVoices);
@@ -91,21 +115,30 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
     |                                                                                                                  |
     -------------------------------------------------------------------------------------------------------------------*/
 
-    link_melodic_arrays(*this, nOfVoices, size, fullChordsVoicing, bassMelodicIntervals,
-                        altoMelodicIntervals, tenorMelodicIntervals, sopranoMelodicIntervals);
-
-    /// global arrays
-    for(int i = 0; i < size-1; i++){
-        rel(*this, expr(*this, allMelodicIntervals[nOfVoices * i + BASS]            == bassMelodicIntervals[i]));
-        rel(*this, expr(*this, allMelodicIntervals[nOfVoices * i + TENOR]           == tenorMelodicIntervals[i]));
-        rel(*this, expr(*this, allMelodicIntervals[nOfVoices * i + ALTO]            == altoMelodicIntervals[i]));
-        rel(*this, expr(*this, allMelodicIntervals[nOfVoices * i + SOPRANO]         == sopranoMelodicIntervals[i]));
+    link_melodic_arrays(*this, nOfVoices, size, fullChordsVoicing, allMelodicIntervals);
+
+    link_harmonic_arrays(*this, nOfVoices, size, fullChordsVoicing, harmonicIntervals);
+
+    /// one pitch class per note, shared by all the rules on notes regardless of their octave
+    pitchClasses = pitch_classes(*this, fullChordsVoicing);
+
+    /// the classes of the intervals, including the ones between voices that are not adjacent, are only needed by the
+    /// decomposed parallel intervals
+    IntVarArray bassTenorIntervalClasses, tenorAltoIntervalClasses, altoSopranoIntervalClasses;
+    IntVarArray bassAltoIntervalClasses, bassSopranoIntervalClasses, tenorSopranoIntervalClasses;
+    if(options.decomposedParallels){
+        harmonicIntervalClasses = pitch_classes(*this, harmonicIntervals);
+        bassTenorIntervalClasses = IntVarArray(*this, harmonicIntervalClasses.slice(BASS, nOfVoices - 1, size));
+        tenorAltoIntervalClasses = IntVarArray(*this, harmonicIntervalClasses.slice(TENOR, nOfVoices - 1, size));
+        altoSopranoIntervalClasses = IntVarArray(*this, harmonicIntervalClasses.slice(ALTO, nOfVoices - 1, size));
+        bassAltoIntervalClasses = pitch_classes(*this,
+                harmonic_intervals(*this, nOfVoices, size, fullChordsVoicing, BASS, ALTO));
+        bassSopranoIntervalClasses = pitch_classes(*this,
+                harmonic_intervals(*this, nOfVoices, size, fullChordsVoicing, BASS, SOPRANO));
+        tenorSopranoIntervalClasses = pitch_classes(*this,
+                harmonic_intervals(*this, nOfVoices, size, fullChordsVoicing, TENOR, SOPRANO));
     }
 
-    link_harmonic_arrays(*this, nOfVoices, size, fullChordsVoicing,
-                         bassTenorHarmonicIntervals, bassAltoHarmonicIntervals, bassSopranoHarmonicIntervals,
-                         tenorAltoHarmonicIntervals, tenorSopranoHarmonicIntervals, altoSopranoHarmonicIntervals);
-
     /**-----------------------------------------------------------------------------------------------------------------
     |                                                                                                                  |
     |                                             set up costs computation                                             |
@@ -114,18 +147,18 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
 
     // @todo add a cost for doubled notes that are not tonal notes -> if a value is not in the tonal notes (1-2-4-5), then its occurence cannot be greater than 1 for each chord
 
+    /// the number of different values and of different notes of each chord are linked to its notes with the harmonic
+    /// constraints below
+
     /// number of diminished chords in fundamental state with more than 3 notes (cost to minimize)
-    compute_diminished_chords_cost(*this, nOfVoices, size,
-                                   chordStates, chordQualities, fullChordsVoicing, nDifferentValuesInDiminishedChord,
-                                   nOfFundStateDiminishedChordsWith4notes);
+    compute_diminished_chords_cost(*this, size, chordStates, chordQualities, nDifferentValuesAllChords,
+                                   nDifferentValuesInDiminishedChord, nOfFundStateDiminishedChordsWith4notes);
 
     /// number of chords with less than 4 note values (cost to minimize)
-    compute_n_of_notes_in_chord_cost(*this, nOfVoices, size, fullChordsVoicing,
-                                     nDifferentValuesAllChords, nOfChordsWithLessThan4Values);
+    compute_n_of_notes_in_chord_cost(*this, nDifferentValuesAllChords, nOfChordsWithLessThan4Values);
 
     /// number of chords that don't have all their possible note values (cost to minimize)
-    compute_cost_for_incomplete_chords(*this, nOfVoices, size, nOfNotesInChord,
-                                       fullChordsVoicing, nOFDifferentNotesInChords, nOfIncompleteChords);
+    compute_cost_for_incomplete_chords(*this, size, nOfNotesInChord, nOFDifferentNotesInChords, nOfIncompleteChords);
 
     /// count the number of common notes in the same voice between consecutive chords (cost to MAXIMIZE)
     /// /!\ The variable nOfCommonNotesInSameVoice has a NEGATIVE value so the minimization will maximize its absolute value
@@ -137,6 +170,9 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
     /// weighted sum of melodic intervals (cost to minimize)
     compute_cost_for_melodic_intervals(*this, allMelodicIntervals, nOfUnissons,
                                        costOfMelodicIntervals, costsAllMelodicIntervals);
+    /// lower bound on the weighted sum from the cheapest melody of each voice
+    if(options.melodicCostBound)
+        melodic_cost_bound(*this, nOfVoices, fullChordsVoicing, costOfMelodicIntervals);
 
     /**-----------------------------------------------------------------------------------------------------------------
     |                                                                                                                  |
@@ -171,6 +207,8 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
 
     for(int i = 0; i < size; i++){
         IntVarArgs currentChord(fullChordsVoicing.slice(nOfVoices * i, 1, nOfVoices));
+        /// the bounds on the occurrences of each note that only depend on the chord
+        ChordOccurrences occurrences(nOfVoices);
 
         /// post the constraints depending on the chord's state
         if(chordStas[i] == FUNDAMENTAL_STATE){
@@ -178,25 +216,63 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
             chord_note_occurrence_fundamental_state(*this, nOfVoices, i, chordDegrees,
                                                     chordQualities, tonality, currentChord,
                                                     nDifferentValuesInDiminishedChord[i],
-                                                    nOFDifferentNotesInChords[i % nOfVoices]);
+                                                    nOFDifferentNotesInChords[i], occurrences);
         }
         /// post the constraints specific to first inversion chords
         else if(chordStas[i] == FIRST_INVERSION){
             chord_note_occurrence_first_inversion(*this, size, nOfVoices, i, tonality,
                                                   chordDegrees, chordQualities, currentChord,
-                                                  bassMelodicIntervals, sopranoMelodicIntervals);
+                                                  bassMelodicIntervals, sopranoMelodicIntervals, occurrences);
         }
         /// post the constraints specific to second inversion chords
         else if(chordStas[i] == SECOND_INVERSION){
             chord_note_occurrence_second_inversion(*this, size, nOfVoices, i, tonality,
-                                                   chordDegrees, chordQualities, currentChord);
+                                                   chordDegrees, chordQualities, currentChord, occurrences);
         }
         else if (chordStas[i] == THIRD_INVERSION){
             chord_note_occurrence_third_inversion(*this, size, nOfVoices, i, tonality,
-                                                  chordDegrees, chordQualities, currentChord);
+                                                  chordDegrees, chordQualities, currentChord, occurrences);
         }
         else{
         }
+
+        /// the nvalues and count constraints on the chord if the decomposition is asked for, otherwise one propagator
+        /// for the occurrences, the different values and the different notes of the chord
+        if(options.decomposedChordContent)
+            chord_content_decomposition(*this, currentChord, pitchClasses.slice(nOfVoices * i, 1, nOfVoices),
+                                        occurrences, nDifferentValuesAllChords[i], nOFDifferentNotesInChords[i]);
+        else
+            chord_content(*this, currentChord, occurrences, nDifferentValuesAllChords[i],
+                          nOFDifferentNotesInChords[i]);
+    }
+
+    /// the legal voicings of each chord and the legal transitions between chords, enumerated on explicit voicings and
+    /// shared by all the problems with the same chords
+    std::unique_ptr<VoicingRules> rules;
+    if(options.transitionTables || options.voicingIndices)
+        rules.reset(new VoicingRules(size, tonality, chordDegrees, chordQualities, chordStates));
+
+    /// one variable per chord choosing its voicing among the legal ones, the notes are channelled with element
+    if(options.voicingIndices){
+        IntVarArgs indices;
+        for(int i = 0; i < size; i++){
+            const vector<PackedVoicing> &legal = rules->legal_packed_voicings(i);
+            if(legal.empty()){
+                fail();
+                indices << IntVar(*this, 0, 0);
+                continue;
+            }
+            indices << IntVar(*this, 0, legal.size() - 1);
+            vector<IntArgs> notes(nOfVoices, IntArgs(legal.size()));
+            for(int k = 0; k < (int) legal.size(); k++){
+                vector<int> voicing = VoicingCache::unpack(legal[k]);
+                for(int voice = BASS; voice <= SOPRANO; voice++)
+                    notes[voice][k] = voicing[voice];
+            }
+            for(int voice = BASS; voice <= SOPRANO; voice++)
+                element(*this, notes[voice], indices[i], fullChordsVoicing[nOfVoices * i + voice]);
+        }
+        voicingIndices = IntVarArray(*this, indices);
     }
 
     /**-----------------------------------------------------------------------------------------------------------------
@@ -208,14 +284,25 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
 
     /// between each chord
     for(int i = 0; i < size-1; i++) {
+        /// the table replaces all the constraints below for this pair of chords, unless it is too large to be kept
+        if(options.transitionTables){
+            const TransitionTable &table = rules->transition_table(i);
+            if(!table.tooLarge){
+                legal_transitions(*this, i, nOfVoices, fullChordsVoicing, table.tuples);
+                continue;
+            }
+        }
+
         /// parallel unissons, fifths and octaves are forbidden unless we have the same chord twice in a row
         if(chordDegrees[i] != chordDegrees[i + 1]){
-            /// @todo maybe do it also <--- so that it can propagate in both directions, if the harmonic interval is a perfect fifth or octave the previous and next chords can't
-            //todo maybe rewrite this
-            forbid_parallel_intervals(*this, size, nOfVoices, {PERFECT_FIFTH, PERFECT_OCTAVE, UNISSON},
-                                      fullChordsVoicing, bassTenorHarmonicIntervals, bassAltoHarmonicIntervals,
-                                      bassSopranoHarmonicIntervals, tenorAltoHarmonicIntervals,
-                                      tenorSopranoHarmonicIntervals, altoSopranoHarmonicIntervals);
+            /// one propagator for the 6 pairs of voices, pruning both chords
+            if(!options.decomposedParallels)
+                parallel_intervals(*this, i, nOfVoices, {PERFECT_FIFTH, PERFECT_OCTAVE, UNISSON}, fullChordsVoicing);
+            else
+                forbid_parallel_intervals(*this, i, nOfVoices, {PERFECT_FIFTH, PERFECT_OCTAVE, UNISSON},
+                                          fullChordsVoicing, bassTenorIntervalClasses, bassAltoIntervalClasses,
+                                          bassSopranoIntervalClasses, tenorAltoIntervalClasses,
+                                          tenorSopranoIntervalClasses, altoSopranoIntervalClasses);
         }
 
         /// resolve the tritone if there is one and it needs to be resolved
@@ -225,7 +312,7 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
             //@todo add other chords that have the tritone
             tritone_resolution(*this, nOfVoices, i, tonality, chordDegrees,
                                chordQualities, chordStates, bassMelodicIntervals,
-                               tenorMelodicIntervals, altoMelodicIntervals, sopranoMelodicIntervals, fullChordsVoicing);
+                               tenorMelodicIntervals, altoMelodicIntervals, sopranoMelodicIntervals, pitchClasses);
         }
 
         /// Exceptions to the general voice leading rules
@@ -233,13 +320,13 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
         /// special rule for interrupted cadence
         if (chordDegrees[i] == FIFTH_DEGREE && chordStates[i] == FUNDAMENTAL_STATE &&
         chordDegrees[i + 1] == SIXTH_DEGREE && chordStates[i + 1] == FUNDAMENTAL_STATE) {
-            interrupted_cadence(*this, i, tonality,
-                                fullChordsVoicing, tenorMelodicIntervals,
+            interrupted_cadence(*this, nOfVoices, i, tonality,
+                                pitchClasses, tenorMelodicIntervals,
                                 altoMelodicIntervals, sopranoMelodicIntervals);
         }
         /// special rules for augmented sixth chords
         else if (chordDegrees[i] == AUGMENTED_SIXTH) {
-            italian_augmented_sixth(*this, nOfVoices, i, tonality, fullChordsVoicing,
+            italian_augmented_sixth(*this, nOfVoices, i, tonality, pitchClasses,
                                     bassMelodicIntervals, tenorMelodicIntervals,
                                     altoMelodicIntervals, sopranoMelodicIntervals);
         }
@@ -247,7 +334,7 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
         /// motion to the bass
         else if(chordDegs[i] == FIRST_DEGREE && chordStates[i] == SECOND_INVERSION &&
                 chordDegs[i+1] == FIFTH_DEGREE && (chordQualities[i] == MAJOR_CHORD || chordQualities[i] == DOMINANT_SEVENTH_CHORD)){
-            fifth_degree_appogiatura(*this, nOfVoices, i, tonality, fullChordsVoicing,
+            fifth_degree_appogiatura(*this, nOfVoices, i, tonality, pitchClasses,
                                      bassMelodicIntervals, tenorMelodicIntervals,
                                      altoMelodicIntervals, sopranoMelodicIntervals);
         }
@@ -256,14 +343,14 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
             if ((chordQualities[i+1] == MAJOR_SEVENTH_CHORD || chordQualities[i+1] == MINOR_SEVENTH_CHORD || chordQualities[i+1] == DIMINISHED_SEVENTH_CHORD
                 || chordQualities[i+1] == HALF_DIMINISHED_CHORD)  && chordDegrees[i+1] <= SEVENTH_DEGREE) {
                 /// the seventh must be prepared
-                species_seventh(*this, nOfVoices, i, tonality, chordDegrees, chordQualities, fullChordsVoicing);
+                species_seventh(*this, nOfVoices, i, tonality, chordDegrees, chordQualities, pitchClasses);
             }
 
             /// If the bass moves by a step, other voices should move in contrary motion
-            int bassFirstChord = (tonality->get_degree_note(chordDegrees[i] + 2 * chordStates[i])
-                    % PERFECT_OCTAVE);
-            int bassSecondChord = (tonality->get_degree_note(chordDegrees[i + 1] + 2 * chordStates[i + 1])
-                    % PERFECT_OCTAVE);
+            int bassFirstChord = (tonality->get_degree_note(chordDegrees[i]) +
+                    get_interval_from_root(chordQualities[i], chordStates[i])) % PERFECT_OCTAVE;
+            int bassSecondChord = (tonality->get_degree_note(chordDegrees[i + 1]) +
+                    get_interval_from_root(chordQualities[i + 1], chordStates[i + 1])) % PERFECT_OCTAVE;
             int bassMelodicMotion = abs(bassSecondChord - bassFirstChord);
             /// if the bass moves by a step between fund. state chords @todo check if this needs to apply in other cases
             if ((bassMelodicMotion == MINOR_SECOND || bassMelodicMotion == MAJOR_SECOND ||
@@ -292,12 +379,66 @@ FourVoiceTexture::FourVoiceTexture(int s, Tonality *t, vector<int> chordDegs, ve
     |                                                                                                                  |
     -------------------------------------------------------------------------------------------------------------------*/
 
-    /// go <-- soprano->bass: 4-3-2-1-8-7-6-5 etc
-    auto r_to_l = [](const Space& home, const IntVar& x, int i) {
-        return i;
-    };
-
-    branch(*this, fullChordsVoicing, INT_VAR_MERIT_MAX(r_to_l), INT_VAL_RND(1U));
+    /// by default go <-- soprano->bass: 4-3-2-1-8-7-6-5 etc with a random value
+    IntValBranch valueSelection;
+    /// try first the note closest to the same voice in the neighbouring chords, the cheapest melodic interval
+    if(options.valueSelection == VAL_CLOSEST_NEIGHBOUR){
+        Rnd rnd(options.seed);
+        valueSelection = INT_VAL([rnd](const Space& home, IntVar x, int i) mutable {
+            return static_cast<const FourVoiceTexture&>(home).closest_neighbour_note(x, i, rnd);
+        });
+    }
+    else
+        valueSelection = value_selection_heuristic(options.valueSelection, options.seed);
+    /// warm start: try the value of the hint first, or the closest value in the domain
+    if(!options.hint.empty()){
+        auto hint = std::make_shared<const vector<int>>(options.hint);
+        valueSelection = INT_VAL([hint](const Space& home, IntVar x, int i) {
+            int h = (*hint)[i];
+            for(int d = 0; ; d++){
+                if(x.in(h - d))
+                    return h - d;
+                if(x.in(h + d))
+                    return h + d;
+            }
+        });
+    }
+    /// a static order or a heuristic learning from the failures, which the restarts keep
+    IntVarBranch variableSelection = variable_selection_heuristic(options.variableSelection, options.decay);
+    if(!options.voicingIndices){
+        branch(*this, fullChordsVoicing, variableSelection, valueSelection);
+        return;
+    }
+    /// one decision per chord: the notes are assigned by the element constraints once the indices are
+    IntValBranch indexSelection;
+    if(options.valueSelection == VAL_CLOSEST_NEIGHBOUR){
+        /// the legal voicings stay in the VoicingCache until the end of the process
+        auto legal = std::make_shared<vector<const vector<PackedVoicing>*>>();
+        for(int i = 0; i < size; i++)
+            legal->push_back(&rules->legal_packed_voicings(i));
+        Rnd rnd(options.seed);
+        indexSelection = INT_VAL([legal, rnd](const Space& home, IntVar x, int i) mutable {
+            return static_cast<const FourVoiceTexture&>(home).closest_neighbour_voicing(x, i, *(*legal)[i], rnd);
+        });
+    }
+    else
+        indexSelection = value_selection_heuristic(options.valueSelection, options.seed);
+    /// warm start: try the voicing of the hint first if it is legal
+    if(!options.hint.empty()){
+        auto hintIndices = std::make_shared<vector<int>>(size, -1);
+        for(int i = 0; i < size; i++){
+            const vector<PackedVoicing> &legal = rules->legal_packed_voicings(i);
+            vector<int> hinted(options.hint.begin() + nOfVoices * i, options.hint.begin() + nOfVoices * (i + 1));
+            auto it = std::find(legal.begin(), legal.end(), VoicingCache::pack(hinted));
+            if(it != legal.end())
+                (*hintIndices)[i] = it - legal.begin();
+        }
+        indexSelection = INT_VAL([hintIndices](const Space& home, IntVar x, int i) {
+            int h = (*hintIndices)[i];
+            return h != -1 && x.in(h) ? h : x.min();
+        });
+    }
+    branch(*this, voicingIndices, variableSelection, indexSelection);
 }
 
 /**
@@ -341,6 +482,187 @@ IntVarArgs FourVoiceTexture::cost() const {
     return costVector;
 }
 
+/**
+ * Returns the melodic cost of playing a note at a position, given the notes of the same voice that are already
+ * assigned in the previous and the next chords. Intervals larger than an octave, which the model forbids, cost more
+ * than any allowed interval.
+ * @param index the index of the note in the form 4 * chord + voice
+ * @param note the value of the note
+ * @return the sum of the costs of the melodic intervals to the assigned neighbours, 0 if there are none
+ */
+int FourVoiceTexture::neighbours_melodic_cost(int index, int note) const {
+    int cost = 0;
+    int intervals[2] = {0, 0};
+    int nOfIntervals = 0;
+    if(index >= nOfVoices && fullChordsVoicing[index - nOfVoices].assigned())
+        intervals[nOfIntervals++] = note - fullChordsVoicing[index - nOfVoices].val();
+    if(index + nOfVoices < fullChordsVoicing.size() && fullChordsVoicing[index + nOfVoices].assigned())
+        intervals[nOfIntervals++] = fullChordsVoicing[index + nOfVoices].val() - note;
+    for(int k = 0; k < nOfIntervals; k++)
+        cost += abs(intervals[k]) <= PERFECT_OCTAVE ? MELODIC_INTERVAL_COSTS[intervals[k] + PERFECT_OCTAVE] :
+                                                      MAX_MELODIC_COST + abs(intervals[k]);
+    return cost;
+}
+
+/**
+ * Value selection of VAL_CLOSEST_NEIGHBOUR for a note: the value with the cheapest melodic intervals to the same voice
+ * in the neighbouring chords, ties being broken at random so that restarts still diversify the search. If no
+ * neighbour is assigned yet, all the values are tied and the value is random.
+ * @param x the note to branch on
+ * @param i the index of the note in fullChordsVoicing
+ * @param rnd the random generator breaking the ties
+ * @return the value to try first
+ */
+int FourVoiceTexture::closest_neighbour_note(IntVar x, int i, Rnd &rnd) const {
+    int best = x.min();
+    int bestCost = -1;
+    unsigned int nOfTies = 0;
+    for(IntVarValues v(x); v(); ++v){
+        int cost = neighbours_melodic_cost(i, v.val());
+        if(bestCost == -1 || cost < bestCost){
+            best = v.val();
+            bestCost = cost;
+            nOfTies = 1;
+        }
+        /// reservoir sampling: each of the tied values is kept with the same probability
+        else if(cost == bestCost && rnd(++nOfTies) == 0)
+            best = v.val();
+    }
+    return best;
+}
+
+/**
+ * Value selection of VAL_CLOSEST_NEIGHBOUR for the index of the voicing of a chord: the voicing with the cheapest
+ * melodic intervals to the neighbouring chords, ties being broken at random
+ * @param x the voicing index to branch on
+ * @param i the position of the chord
+ * @param legal the legal voicings of the chord
+ * @param rnd the random generator breaking the ties
+ * @return the index to try first
+ */
+int FourVoiceTexture::closest_neighbour_voicing(IntVar x, int i, const vector<PackedVoicing> &legal, Rnd &rnd) const {
+    int best = x.min();
+    int bestCost = -1;
+    unsigned int nOfTies = 0;
+    for(IntVarValues v(x); v(); ++v){
+        vector<int> voicing = VoicingCache::unpack(legal[v.val()]);
+        int cost = 0;
+        for(int voice = BASS; voice <= SOPRANO; voice++)
+            cost += neighbours_melodic_cost(nOfVoices * i + voice, voicing[voice]);
+        if(bestCost == -1 || cost < bestCost){
+            best = v.val();
+            bestCost = cost;
+            nOfTies = 1;
+        }
+        else if(cost == bestCost && rnd(++nOfTies) == 0)
+            best = v.val();
+    }
+    return best;
+}
+
+/**
+ * Constrains the cost vector to be lexicographically smaller than the best one found by the other engines sharing
+ * the bound. Does nothing if the bound is not shared or if no solution was found yet.
+ */
+void FourVoiceTexture::post_shared_bound() {
+    vector<int> bestCosts;
+    if(sharedBound != nullptr && sharedBound->get(bestCosts))
+        rel(*this, costVector, IRT_LE, IntArgs(bestCosts));
+}
+
+/**
+ * Constrains the cost vector to be lexicographically smaller than the worst solution of the archive once it is
+ * full, and the first cost to be within the margin of the best archived solution
+ */
+void FourVoiceTexture::post_archive_bound() {
+    vector<int> worstCosts;
+    if(archive->worst(worstCosts))
+        rel(*this, costVector, IRT_LE, IntArgs(worstCosts));
+    int firstCostBound;
+    if(archive->first_cost_bound(firstCostBound))
+        rel(*this, costVector[0], IRT_LQ, firstCostBound);
+}
+
+/**
+ * Constrains the cost vector to be better than the one of the given solution, and than the best one found by the
+ * other engines sharing the bound. If solutions are archived, the cost vector only has to be better than the worst
+ * archived solution.
+ * @param best the best solution found so far by this engine
+ */
+void FourVoiceTexture::constrain(const Space &best) {
+    if(archive != nullptr){
+        post_archive_bound();
+        return;
+    }
+    IntLexMinimizeSpace::constrain(best);
+    post_shared_bound();
+}
+
+/**
+ * Called on each restart. Posts the bound of the last solution and the no-goods, as well as the bound shared by the
+ * other engines
+ * @param mi the information about the restart
+ * @return true to perform the restart
+ */
+bool FourVoiceTexture::master(const MetaInfo &mi) {
+    bool restart = IntLexMinimizeSpace::master(mi);
+    post_shared_bound();
+    return restart;
+}
+
+/**
+ * Chooses the first chord of the window relaxed by the large neighbourhood search
+ * @param incumbent the best solution found so far
+ * @param restart the number of the restart, used to alternate the neighbourhoods
+ * @return the index of the first chord of the window
+ */
+int FourVoiceTexture::lns_window_start(const FourVoiceTexture &incumbent, unsigned long int restart) {
+    int nOfWindows = size - lnsWindow + 1;
+    if(lnsNeighbourhood == LNS_RANDOM_WINDOW || (lnsNeighbourhood == LNS_MIXED_WINDOW && restart % 2 == 0))
+        return lnsRnd(nOfWindows);
+
+    /// the cost of a chord is the cost of the melodic intervals into and out of it, plus a penalty if it is incomplete
+    vector<int> chordCosts(size, 1);
+    for(int i = 0; i < size; i++){
+        if(incumbent.nOFDifferentNotesInChords[i].val() < problem->nOfNotesInChord[i])
+            chordCosts[i] += nOfVoices * MAX_MELODIC_COST;
+        for(int v = 0; v < nOfVoices; v++){
+            if(i > 0)
+                chordCosts[i] += incumbent.costsAllMelodicIntervals[nOfVoices * (i - 1) + v].val();
+            if(i < size - 1)
+                chordCosts[i] += incumbent.costsAllMelodicIntervals[nOfVoices * i + v].val();
+        }
+    }
+    /// choose a chord proportionally to its cost and center the window on it
+    int total = 0;
+    for(auto c : chordCosts)
+        total += c;
+    int r = lnsRnd(total);
+    int chord = 0;
+    while(r >= chordCosts[chord])
+        r -= chordCosts[chord++];
+    return max(0, min(chord - lnsWindow / 2, nOfWindows - 1));
+}
+
+/**
+ * Called on the space explored after each restart. If large neighbourhood search is enabled and a solution has
+ * been found, all the chords outside of a window are assigned to their value in the last solution. A window covering
+ * the whole progression relaxes every chord, so the search stays complete.
+ * @param mi the information about the restart
+ * @return true if the search of the space is complete, false if it is restricted to a neighbourhood
+ */
+bool FourVoiceTexture::slave(const MetaInfo &mi) {
+    if(lnsWindow <= 0 || lnsWindow >= size || mi.type() != MetaInfo::RESTART || mi.last() == nullptr)
+        return IntLexMinimizeSpace::slave(mi);
+    const FourVoiceTexture &incumbent = static_cast<const FourVoiceTexture&>(*mi.last());
+    int start = lns_window_start(incumbent, mi.restart());
+    for(int i = 0; i < nOfVoices * size; i++){
+        if(i / nOfVoices < start || i / nOfVoices >= start + lnsWindow)
+            rel(*this, fullChordsVoicing[i], IRT_EQ, incumbent.fullChordsVoicing[i].val());
+    }
+    return false;
+}
+
 /**
  * Copy constructor
  * @param s an instance of the FourVoiceTexture class
@@ -349,20 +671,18 @@ IntVarArgs FourVoiceTexture::cost() const {
  */
 FourVoiceTexture::FourVoiceTexture(FourVoiceTexture& s): IntLexMinimizeSpace(s){
     size = s.size;
-    tonality = s.tonality;
-    chordDegrees = s.chordDegrees;
-    chordQualities = s.chordQualities;
-    nOfNotesInChord = s.nOfNotesInChord;
-    chordStates = s.chordStates;
-
-    bassMelodicIntervals.update(*this, s.bassMelodicIntervals);
-    tenorMelodicIntervals.update(*this, s.tenorMelodicIntervals);
-    altoMelodicIntervals.update(*this, s.altoMelodicIntervals);
-    sopranoMelodicIntervals.update(*this, s.sopranoMelodicIntervals);
-
-    bassTenorHarmonicIntervals.update(*this, s.bassTenorHarmonicIntervals);
-    tenorAltoHarmonicIntervals.update(*this, s.tenorAltoHarmonicIntervals);
-    altoSopranoHarmonicIntervals.update(*this, s.altoSopranoHarmonicIntervals);
+    problem = s.problem;
+    sharedBound = s.sharedBound;
+    archive = s.archive;
+    lnsWindow = s.lnsWindow;
+    lnsNeighbourhood = s.lnsNeighbourhood;
+    lnsRnd = s.lnsRnd;
+
+    allMelodicIntervals.update(*this, s.allMelodicIntervals);
+    harmonicIntervals.update(*this, s.harmonicIntervals);
+    pitchClasses.update(*this, s.pitchClasses);
+    harmonicIntervalClasses.update(*this, s.harmonicIntervalClasses);
+    voicingIndices.update(*this, s.voicingIndices);
 
     fullChordsVoicing.update(*this, s.fullChordsVoicing);
 
@@ -392,6 +712,24 @@ int FourVoiceTexture::get_size() const{ return size; }
 
 IntVarArray FourVoiceTexture::getFullVoicing() { return fullChordsVoicing; }
 
+/**
+ * Assigns the notes of all the chords to the given voicing, for example one found by another solving engine
+ * @param voicing the notes of the chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ */
+void FourVoiceTexture::fix_voicing(const vector<int> &voicing) {
+    for(int i = 0; i < nOfVoices * size; i++)
+        rel(*this, fullChordsVoicing[i], IRT_EQ, voicing[i]);
+}
+
+/**
+ * Assigns a single note of the progression, for example to split the search tree into subproblems
+ * @param index the index of the note in the form 4 * chord + voice
+ * @param note the value of the note
+ */
+void FourVoiceTexture::fix_note(int index, int note) {
+    rel(*this, fullChordsVoicing[index], IRT_EQ, note);
+}
+
 /**
  * Copy method
  * @return a copy of the current instance of the FourVoiceTexture class. Calls the copy constructor
@@ -427,17 +765,18 @@ IntVarArgs FourVoiceTexture::get_cost_vector() const{
 string FourVoiceTexture::parameters(){
     string message = "-----------------------------------------parameters-----------------------------------------\n";
     message += "Number of chords: " + std::to_string(size) + "\n";
-    message += "Tonality: " + midi_to_letter(tonality->get_tonic()) + " " + mode_int_to_name(tonality->get_mode()) + "\n";
+    message += "Tonality: " + midi_to_letter(problem->tonality->get_tonic()) + " " +
+               mode_int_to_name(problem->tonality->get_mode()) + "\n";
     message += "Chords: \n";
     for(int i = 0; i < size; i++){
-        message += degreeNames[chordDegrees[i]] + " (" + chordQualityNames[chordQualities[i]] + ") in " +
-                   stateNames[chordStates[i]];
+        message += degreeNames[problem->chordDegrees[i]] + " (" + chordQualityNames[problem->chordQualities[i]] +
+                   ") in " + stateNames[problem->chordStates[i]];
         if(i != size - 1)
             message += ",\n";
     }
     message += ".\n Maximum number of notes in each chord: { ";
     for(int i = 0; i < size; i++){
-        message += std::to_string(nOfNotesInChord[i]) + " ";
+        message += std::to_string(problem->nOfNotesInChord[i]) + " ";
     }
     return message + "}\n";
 }
@@ -458,14 +797,14 @@ string FourVoiceTexture::to_string(){
     message += parameters();
     message += "\n-----------------------------------------variables------------------------------------------\n";
 
-    message += "BassTenorHarmonicIntervals = \t" + intVarArray_to_string(bassTenorHarmonicIntervals) + "\n";
-    message += "TenorAltoHarmonicIntervals = \t" + intVarArray_to_string(tenorAltoHarmonicIntervals) + "\n";
-    message += "AltoSopranoHarmonicIntervals = \t" + intVarArray_to_string(altoSopranoHarmonicIntervals) + "\n\n";
+    message += "BassTenorHarmonicIntervals = \t" + intVarArgs_to_string(harmonicIntervals.slice(BASS, nOfVoices - 1, size)) + "\n";
+    message += "TenorAltoHarmonicIntervals = \t" + intVarArgs_to_string(harmonicIntervals.slice(TENOR, nOfVoices - 1, size)) + "\n";
+    message += "AltoSopranoHarmonicIntervals = \t" + intVarArgs_to_string(harmonicIntervals.slice(ALTO, nOfVoices - 1, size)) + "\n\n";
 
-    message += "BassMelodicIntervals = \t\t" + intVarArray_to_string(bassMelodicIntervals) + "\n";
-    message += "TenorMelodicIntervals = \t" + intVarArray_to_string(tenorMelodicIntervals) + "\n";
-    message += "AltoMelodicIntervals = \t\t" + intVarArray_to_string(altoMelodicIntervals) + "\n";
-    message += "SopranoMelodicIntervals = \t" + intVarArray_to_string(sopranoMelodicIntervals) + "\n\n";
+    message += "BassMelodicIntervals = \t\t" + intVarArgs_to_string(allMelodicIntervals.slice(BASS, nOfVoices, size - 1)) + "\n";
+    message += "TenorMelodicIntervals = \t" + intVarArgs_to_string(allMelodicIntervals.slice(TENOR, nOfVoices, size - 1)) + "\n";
+    message += "AltoMelodicIntervals = \t\t" + intVarArgs_to_string(allMelodicIntervals.slice(ALTO, nOfVoices, size - 1)) + "\n";
+    message += "SopranoMelodicIntervals = \t" + intVarArgs_to_string(allMelodicIntervals.slice(SOPRANO, nOfVoices, size - 1)) + "\n\n";
     message += "AllMelodicIntervals = \t\t" + intVarArray_to_string(allMelodicIntervals) + "\n\n";
 
     message += "🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵🎵"
@@ -10,6 +10,8 @@
  *     - link_melodic_arrays: links the melodic intervals arrays to the fullChordsVoicing array for each voice         *
  *     - link_squared_melodic_arrays: links the absolute melodic intervals arrays to the corresponding melodic arrays *
  *     - link_harmonic_arrays: links the harmonic intervals arrays to the fullChordsVoicing array for each voice       *
+ *     - harmonic_intervals: creates the harmonic intervals between two voices that are not adjacent                  *
+ *     - pitch_classes: creates the pitch classes of notes, or the interval classes of intervals                      *
  *     - restrain_voices_domains: sets the domains of the different voices to their range and gives them their order   *
  *                                                                                                                     *
  ***********************************************************************************************************************/
@@ -40,56 +42,75 @@ void restrain_voices_domains(const Home &home, int nVoices, int n,
 }
 
 /**
- * Link the melodic intervals arrays to the fullChordsVoicing array
+ * Link the melodic intervals array to the fullChordsVoicing array
  * @param home The instance of the problem
  * @param nVoices the number of voices
  * @param size the number of chords
- * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1,...]
- * @param bassMelodicIntervals the melodic intervals of the bass
- * @param tenorMelodicIntervals the melodic intervals of the tenor
- * @param altoMelodicIntervals the melodic intervals of the alto
- * @param sopranoMelodicIntervals the melodic intervals of the soprano
+ * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
+ * @param allMelodicIntervals the melodic intervals of all voices in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ * where bass0 is the interval of the bass between the first and the second chord
  */
 void link_melodic_arrays(const Home &home, int nVoices, int size,
-                         IntVarArray fullChordsVoicing,     IntVarArray bassMelodicIntervals,
-                         IntVarArray altoMelodicIntervals,  IntVarArray tenorMelodicIntervals,
-                         IntVarArray sopranoMelodicIntervals) {
+                         IntVarArray fullChordsVoicing, IntVarArray allMelodicIntervals) {
 
     for (int i = 0; i < size - 1; ++i)
-    {
-        rel(home, bassMelodicIntervals[i]    == fullChordsVoicing[(i + 1) * nVoices + BASS]      - fullChordsVoicing[i * nVoices + BASS]);
-        rel(home, tenorMelodicIntervals[i]   == fullChordsVoicing[((i + 1) * nVoices) + TENOR]   - fullChordsVoicing[(i * nVoices) + TENOR]);
-        rel(home, altoMelodicIntervals[i]    == fullChordsVoicing[((i + 1) * nVoices) + ALTO]    - fullChordsVoicing[(i * nVoices) + ALTO]);
-        rel(home, sopranoMelodicIntervals[i] == fullChordsVoicing[((i + 1) * nVoices) + SOPRANO] - fullChordsVoicing[(i * nVoices) + SOPRANO]);
-    }
+        for (int voice = BASS; voice <= SOPRANO; ++voice)
+            rel(home, allMelodicIntervals[nVoices * i + voice] ==
+                      fullChordsVoicing[(i + 1) * nVoices + voice] - fullChordsVoicing[i * nVoices + voice]);
 }
 
 /**
- * Link the harmonic intervals arrays to the fullChordsVoicing array for each voice
+ * Link the harmonic intervals array to the fullChordsVoicing array for each pair of adjacent voices
  * @param home the instance of the problem
  * @param nVoices the number of voices in the chords
  * @param size the number of chords
  * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
- * @param bassTenorHarmonicIntervals the harmonic intervals between bass and tenor
- * @param bassAltoHarmonicIntervals the harmonic intervals between bass and alto
- * @param bassSopranoHarmonicIntervals the harmonic intervals between bass and soprano
- * @param tenorAltoHarmonicIntervals the harmonic intervals between tenor and alto
- * @param tenorSopranoHarmonicIntervals the harmonic intervals between tenor and soprano
- * @param altoSopranoHarmonicIntervals the harmonic intervals between alto and soprano
+ * @param harmonicIntervals the harmonic intervals between adjacent voices in the form [bassTenor0, tenorAlto0,
+ * altoSoprano0, bassTenor1, ...]
  */
-void link_harmonic_arrays(const Home &home, int nVoices, int size,   IntVarArray fullChordsVoicing,
-                          IntVarArray bassTenorHarmonicIntervals,    IntVarArray bassAltoHarmonicIntervals,
-                          IntVarArray bassSopranoHarmonicIntervals,  IntVarArray tenorAltoHarmonicIntervals,
-                          IntVarArray tenorSopranoHarmonicIntervals, IntVarArray altoSopranoHarmonicIntervals) {
+void link_harmonic_arrays(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
+                          IntVarArray harmonicIntervals) {
 
-    for(int i = 0; i < size; ++i){
-        rel(home, bassTenorHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + TENOR] - fullChordsVoicing[nVoices * i + BASS]);
-        rel(home, bassAltoHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + ALTO] - fullChordsVoicing[nVoices * i + BASS]);
-        rel(home, bassSopranoHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + SOPRANO] - fullChordsVoicing[nVoices * i + BASS]);
+    for(int i = 0; i < size; ++i)
+        for(int voice = BASS; voice < SOPRANO; ++voice)
+            rel(home, harmonicIntervals[(nVoices - 1) * i + voice] ==
+                      fullChordsVoicing[nVoices * i + voice + 1] - fullChordsVoicing[nVoices * i + voice]);
+}
 
-        rel(home, tenorAltoHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + ALTO] - fullChordsVoicing[(nVoices * i) + TENOR]);
-        rel(home, tenorSopranoHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + SOPRANO] - fullChordsVoicing[(nVoices * i) + TENOR]);
+/**
+ * Creates the harmonic intervals between two voices that are not adjacent. They are implied by the intervals between
+ * adjacent voices, so they are only needed by the constraints that are stated on them.
+ * @param home the instance of the problem
+ * @param nVoices the number of voices in the chords
+ * @param size the number of chords
+ * @param fullChordsVoicing the array containing all the chords in the form [bass0, alto0, tenor0, soprano0, bass1, ...]
+ * @param lowerVoice the lower voice
+ * @param upperVoice the upper voice
+ * @return the harmonic intervals between the two voices in each chord
+ */
+IntVarArray harmonic_intervals(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
+                               int lowerVoice, int upperVoice) {
+    IntVarArgs intervals;
+    for(int i = 0; i < size; ++i)
+        intervals << expr(home, fullChordsVoicing[nVoices * i + upperVoice] - fullChordsVoicing[nVoices * i + lowerVoice]);
+    return IntVarArray(home, intervals);
+}
 
-        rel(home, altoSopranoHarmonicIntervals[i] == fullChordsVoicing[(nVoices * i) + SOPRANO] - fullChordsVoicing[(nVoices * i) + ALTO]);
-    }
-}
\ No newline at end of file
+/**
+ * Creates the pitch classes [0,11] of an array of notes, or the interval classes of an array of positive intervals. Each
+ * class is channelled to its value with a single element constraint on a table of classes, which is domain consistent,
+ * so the rules stated on classes share these variables instead of posting their own modulo.
+ * @param home the instance of the problem
+ * @param values the notes [0,127] or the positive intervals
+ * @return the classes of the values, in the same order
+ */
+IntVarArray pitch_classes(const Home &home, const IntVarArray &values) {
+    /// the class of every value a note can take
+    IntArgs classes(128);
+    for(int v = 0; v < 128; v++)
+        classes[v] = v % PERFECT_OCTAVE;
+    IntVarArray result(home, values.size(), 0, PERFECT_OCTAVE - 1);
+    for(int i = 0; i < values.size(); i++)
+        element(home, classes, values[i], result[i]);
+    return result;
+}
@@ -13,6 +13,8 @@
  *      - set_bass: sets the bass of the chord according to the state of the chord                                     *
  *      - chord_note_occurrence_fundamental_state: sets the number of times each note in the chord are present for     *
  *          fundamental state chords                                                                                   *
+ *      - chord_content_decomposition: enforces the occurrences of the notes of a chord with count constraints and     *
+ *          counts its different values and notes with nvalues constraints                                             *
  *                                                                                                                     *
  ***********************************************************************************************************************/
 
@@ -29,9 +31,7 @@
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
  */
 void set_to_chord(const Home& home, Tonality* tonality, int degree, int quality, const IntVarArgs& currentChord){
-    IntSet set(get_all_notes_in_chord(tonality->get_degree_note(degree), quality));
-    //std::cout << "set: " << set << std::endl;
-    dom(home, currentChord, set);
+    dom(home, currentChord, get_all_notes_in_chord_set(tonality->get_degree_note(degree), quality));
 }
 
 /**
@@ -45,7 +45,7 @@ void set_to_chord(const Home& home, Tonality* tonality, int degree, int quality,
  */
 void set_bass(const Home &home, Tonality *tonality, int degree, int quality, int state, IntVarArgs currentChord) {
     auto diff = get_interval_from_root(quality, state);
-    dom(home, currentChord[0], IntSet(get_all_given_note((tonality->get_degree_note(degree) + diff) % PERFECT_OCTAVE)));
+    dom(home, currentChord[0], get_all_given_note_set(tonality->get_degree_note(degree) + diff));
 }
 
 /***********************************************************************************************************************
@@ -64,11 +64,12 @@ void set_bass(const Home &home, Tonality *tonality, int degree, int quality, int
  * @param tonality the tonality of the piece
  * @param nDifferentValuesInDiminishedChord the number of different values in the diminished chord
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_fundamental_state(Home home, int nVoices, int pos, vector<int> degrees, vector<int> qualities,
                                              Tonality *tonality, const IntVarArgs &currentChord,
                                              const IntVar &nDifferentValuesInDiminishedChord,
-                                             const IntVar &nOfNotesInChord) {
+                                             const IntVar &nOfNotesInChord, ChordOccurrences &occurrences) {
 
     auto root = tonality->get_degree_note(degrees[pos]);
     auto third = (root + get_interval_from_root(qualities[pos],THIRD)) % PERFECT_OCTAVE;
@@ -80,81 +81,81 @@ void chord_note_occurrence_fundamental_state(Home home, int nVoices, int pos, ve
         /// If there are 4 different notes, then the third must be doubled. Otherwise any note can be doubled as
         /// there are only 3 values
         IntVar nOfThirds(home,0,nVoices);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, nOfThirds);
+        count(home, currentChord, get_all_given_note_set(third), IRT_EQ, nOfThirds);
         /// if there are 4 different notes, then the third must be doubled
         rel(home, expr(home, nDifferentValuesInDiminishedChord == nVoices), BOT_IMP,
             expr(home, nOfThirds == 2), true);
         /// each note is present at least once, doubling is determined by the costs
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_GQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_GQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_GQ,1);
+        occurrences.restrain(root, IRT_GQ, 1);
+        occurrences.restrain(third, IRT_GQ, 1);
+        occurrences.restrain(fifth, IRT_GQ, 1);
     }
     else if (degrees[pos] == FLAT_TWO) {
         //std::cout << "bII" << std::endl;
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 2);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_GQ, 1);
+        occurrences.restrain(root, IRT_EQ, 1);
+        occurrences.restrain(third, IRT_EQ, 2);
+        occurrences.restrain(fifth, IRT_GQ, 1);
     }
     else if (degrees[pos] == AUGMENTED_SIXTH) {
         //std::cout << "Aug. 6th" << std::endl;
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 2);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_EQ, 1);
+        occurrences.restrain(root, IRT_EQ, 1);
+        occurrences.restrain(third, IRT_EQ, 2);
+        occurrences.restrain(fifth, IRT_EQ, 1);
     }
     /// special rule for sixth degree because in the case of an interrupted cadence, the third of the chord is doubled instead of the fundamental
     else if(degrees[pos] == SIXTH_DEGREE && pos > 0 && degrees[pos-1] == FIFTH_DEGREE){
         /// double the third of the chord
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ,2);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_EQ, 1);
+        occurrences.restrain(root, IRT_EQ, 1);
+        occurrences.restrain(third, IRT_EQ, 2);
+        occurrences.restrain(fifth, IRT_EQ, 1);
     }
     else if(degrees[pos] == FIFTH_DEGREE || (degrees[pos] >= FIVE_OF_TWO && degrees[pos] <= FIVE_OF_SEVEN)){
         /// If there is a perfect cadence, then one of the chords must be incomplete.
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_GQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_LQ, 1);
+        occurrences.restrain(root, IRT_GQ, 1);
+        occurrences.restrain(third, IRT_EQ, 1);
+        occurrences.restrain(fifth, IRT_LQ, 1);
 
         if(qualities[pos] >= DOMINANT_SEVENTH_CHORD){
             auto seventh = (root + get_interval_from_root(qualities[pos],SEVENTH)) % PERFECT_OCTAVE;
             /// the seventh must be present
-            count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_EQ, 1);
+            occurrences.restrain(seventh, IRT_EQ, 1);
             /// if the chord is incomplete, double the bass
             BoolVar isIncomplete(expr(home, nOfNotesInChord < 4));
             IntVar nOfBassNotes(home,0,4);
-            count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ,nOfBassNotes);
+            count(home, currentChord, get_all_given_note_set(root), IRT_EQ,nOfBassNotes);
             rel(home, isIncomplete, BOT_EQV, expr(home, nOfBassNotes == 2), true);
         }
     }
     else if(degrees[pos] == FIRST_DEGREE){
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_GQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_LQ, 1);
+        occurrences.restrain(root, IRT_GQ, 1);
+        occurrences.restrain(third, IRT_EQ, 1);
+        occurrences.restrain(fifth, IRT_LQ, 1);
         /// if the chord is incomplete, then the bass must be tripled and the third should be there once.
         BoolVar isIncomplete(expr(home, nOfNotesInChord < 3));
         IntVar nOfBassNotes(home,0,4);
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ,nOfBassNotes);
+        count(home, currentChord, get_all_given_note_set(root), IRT_EQ,nOfBassNotes);
         rel(home, isIncomplete, BOT_EQV, expr(home, nOfBassNotes == 3), true);
         if(qualities[pos] >= DOMINANT_SEVENTH_CHORD){
             auto seventh = (root + get_interval_from_root(qualities[pos],SEVENTH)) % PERFECT_OCTAVE;
             /// the seventh must be present
-            count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_EQ, 1);
+            occurrences.restrain(seventh, IRT_EQ, 1);
         }
     }
     else{
         //std::cout << "Degree: " << degrees[pos]  << " Quality: " << qualities[pos] << std::endl;
         /// each note is present at least once, the bass is present at least once, the third exactly once and the fifth at most once
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_GQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ,1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_LQ, 1);
+        occurrences.restrain(root, IRT_GQ, 1);
+        occurrences.restrain(third, IRT_EQ, 1);
+        occurrences.restrain(fifth, IRT_LQ, 1);
 
         if(qualities[pos] >= DOMINANT_SEVENTH_CHORD){
             auto seventh = (root + get_interval_from_root(qualities[pos],SEVENTH)) % PERFECT_OCTAVE;
             /// the seventh must be present
-            count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_EQ, 1);
+            occurrences.restrain(seventh, IRT_EQ, 1);
         }
         else{
             /// the fifth must be present exactly once
-            count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_EQ, 1);
+            occurrences.restrain(fifth, IRT_EQ, 1);
         }
     }
 }
@@ -178,24 +179,25 @@ void chord_note_occurrence_fundamental_state(Home home, int nVoices, int pos, ve
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
  * @param bassMelodicIntervals the array containing the melodic intervals of the bass
  * @param sopranoMelodicIntervals the array containing the melodic intervals of the soprano
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int currentPos, Tonality *tonality,
                                            vector<int> degrees, vector<int> qualities,
                                            const IntVarArgs &currentChord, IntVarArray bassMelodicIntervals,
-                                           IntVarArray sopranoMelodicIntervals){
+                                           IntVarArray sopranoMelodicIntervals, ChordOccurrences &occurrences){
     auto root = tonality->get_degree_note(degrees[currentPos]);
     auto third = (root + get_interval_from_root(qualities[currentPos],THIRD)) % PERFECT_OCTAVE;
     auto fifth = (root + get_interval_from_root(qualities[currentPos],FIFTH)) % PERFECT_OCTAVE;
 
     /// if the third is a tonal note, then double it
-    set<int> tonalNotes = tonality->get_tonal_notes();
+    const set<int> &tonalNotes = tonality->get_tonal_notes();
     if(tonalNotes.find(third) != tonalNotes.end()) { /// double the third and other notes should be present at least once
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 2);
+        occurrences.restrain(third, IRT_EQ, 2);
     }
     else if((degrees[currentPos] == SEVENTH_DEGREE && qualities[currentPos] == DIMINISHED_CHORD) ||
         degrees[currentPos] == FLAT_TWO) {
         /// double the third and other notes should be present at least once
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 2);
+        occurrences.restrain(third, IRT_EQ, 2);
     }
     /// Dominant diminished seventh chords (aka minor ninth dominant chords without the root)
     else if ((degrees[currentPos] == FIFTH_DEGREE || (degrees[currentPos] >= FIVE_OF_TWO && degrees[currentPos] <= FIVE_OF_SEVEN))
@@ -206,10 +208,10 @@ void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int
         auto fifth_dim = (third_dim + MINOR_THIRD) % PERFECT_OCTAVE;
         auto seventh_dim = (fifth_dim + MINOR_THIRD) % PERFECT_OCTAVE;
 
-        count(home, currentChord, IntSet(get_all_given_note(root_dim)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(third_dim)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth_dim)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(seventh_dim)), IRT_EQ, 1);
+        occurrences.restrain(root_dim, IRT_EQ, 1);
+        occurrences.restrain(third_dim, IRT_EQ, 1);
+        occurrences.restrain(fifth_dim, IRT_EQ, 1);
+        occurrences.restrain(seventh_dim, IRT_EQ, 1);
         }
     else{ /// default case: double the fundamental or the fifth of the chord unless the top and bottom voices move down and up respectively
         if(currentPos < size-1 && currentPos > 0){ /// this special case cannot happen on the first and last chord
@@ -237,23 +239,23 @@ void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int
             BoolVar contraryMotion = expr(home, bassRisesOverall && sopranoFallsOverall);
 
             IntVar nOfBassNotes(home,0,nVoices);
-            count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ,nOfBassNotes);
+            count(home, currentChord, get_all_given_note_set(third), IRT_EQ,nOfBassNotes);
             rel(home, contraryMotion, BOT_EQV, expr(home, nOfBassNotes == 2), true);
             rel(home, expr(home, !contraryMotion), BOT_EQV, expr(home, nOfBassNotes == 1), true);
         }
         else{ /// the bass can't be doubled
-            count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
+            occurrences.restrain(root, IRT_EQ, 1);
         }
     }
     /// each note always has to be present at least once
     if (qualities[currentPos] != MINOR_NINTH_DOMINANT_CHORD) {
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_GQ, 1);
+        occurrences.restrain(root, IRT_GQ, 1);
     }
-    count(home, currentChord, IntSet(get_all_given_note(third)), IRT_GQ, 1);
-    count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_GQ, 1);
+    occurrences.restrain(third, IRT_GQ, 1);
+    occurrences.restrain(fifth, IRT_GQ, 1);
     if(qualities[currentPos] >= DOMINANT_SEVENTH_CHORD){
         auto seventh = (root + get_interval_from_root(qualities[currentPos],SEVENTH)) % PERFECT_OCTAVE;
-        count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_GQ, 1);
+        occurrences.restrain(seventh, IRT_GQ, 1);
     }
 
 }
@@ -274,26 +276,28 @@ void chord_note_occurrence_first_inversion(Home home, int size, int nVoices, int
  * @param degrees the degree of the chord
  * @param qualities the qualities of the chords
  * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param occurrences restrained with the bounds on the occurrences of each note that only depend on the chord
  */
 void chord_note_occurrence_second_inversion(const Home& home, int size, int nVoices, int currentPos, Tonality *tonality,
-                                            vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord){
+                                            vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord,
+                                            ChordOccurrences &occurrences){
     auto root = tonality->get_degree_note(degrees[currentPos]);
     auto third = (root + get_interval_from_root(qualities[currentPos],THIRD)) % PERFECT_OCTAVE;
     auto fifth = (root + get_interval_from_root(qualities[currentPos],FIFTH)) % PERFECT_OCTAVE;
 
     if(degrees[currentPos] == SEVENTH_DEGREE && qualities[currentPos] == DIMINISHED_CHORD) {
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 2);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_EQ, 1);
+        occurrences.restrain(root, IRT_EQ, 1);
+        occurrences.restrain(third, IRT_EQ, 2);
+        occurrences.restrain(fifth, IRT_EQ, 1);
     }
     else{ /// default case: if the fourth or the sixth of the chord are in the chord before, they can be doubled if it is in the chord before at the same height
         /// the bass can always be doubled -> @todo
-        count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 1);
-        count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_GQ, 1);
+        occurrences.restrain(root, IRT_EQ, 1);
+        occurrences.restrain(third, IRT_EQ, 1);
+        occurrences.restrain(fifth, IRT_GQ, 1);
         if(qualities[currentPos] >= DOMINANT_SEVENTH_CHORD){
             auto seventh = (root + get_interval_from_root(qualities[currentPos],SEVENTH)) % PERFECT_OCTAVE;
-            count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_EQ, 1);
+            occurrences.restrain(seventh, IRT_EQ, 1);
         }
     }
 }
@@ -308,9 +312,11 @@ void chord_note_occurrence_second_inversion(const Home& home, int size, int nVoi
  * @param degrees
  * @param qualities
  * @param currentChord
+ * @param occurrences
  */
 void chord_note_occurrence_third_inversion(const Home& home, int size, int nVoices, int currentPos, Tonality *tonality,
-                                           vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord) {
+                                           vector<int> degrees, vector<int> qualities, const IntVarArgs &currentChord,
+                                           ChordOccurrences &occurrences) {
     if (qualities[currentPos] < DOMINANT_SEVENTH_CHORD) {
         throw std::invalid_argument("The chord cannot be in third inversion");
     }
@@ -318,11 +324,39 @@ void chord_note_occurrence_third_inversion(const Home& home, int size, int nVoic
     auto third = (root + get_interval_from_root(qualities[currentPos],THIRD)) % PERFECT_OCTAVE;
     auto fifth = (root + get_interval_from_root(qualities[currentPos],FIFTH)) % PERFECT_OCTAVE;
 
-    count(home, currentChord, IntSet(get_all_given_note(root)), IRT_EQ, 1);
-    count(home, currentChord, IntSet(get_all_given_note(third)), IRT_EQ, 1);
-    count(home, currentChord, IntSet(get_all_given_note(fifth)), IRT_GQ, 1);
+    occurrences.restrain(root, IRT_EQ, 1);
+    occurrences.restrain(third, IRT_EQ, 1);
+    occurrences.restrain(fifth, IRT_GQ, 1);
     if(qualities[currentPos] >= DOMINANT_SEVENTH_CHORD){
         auto seventh = (root + get_interval_from_root(qualities[currentPos],SEVENTH)) % PERFECT_OCTAVE;
-        count(home, currentChord, IntSet(get_all_given_note(seventh)), IRT_EQ, 1);
+        occurrences.restrain(seventh, IRT_EQ, 1);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Enforces the bounds on the occurrences of each note of a chord with count constraints, and counts the different
+ * values and notes (regardless of their octave) of the chord with nvalues constraints. This is the decomposition of the
+ * ChordContent propagator.
+ * @param home the instance of the problem
+ * @param currentChord the array containing a chord in the form [bass, alto, tenor, soprano]
+ * @param currentChordNotes the pitch classes of the notes of the chord
+ * @param occurrences the bounds on the occurrences of each note
+ * @param nOfValues the number of different values in the chord
+ * @param nOfNotes the number of different notes in the chord
+ */
+void chord_content_decomposition(const Home &home, const IntVarArgs &currentChord, const IntVarArgs &currentChordNotes,
+                                 const ChordOccurrences &occurrences, const IntVar &nOfValues, const IntVar &nOfNotes) {
+    for(int note = 0; note < PERFECT_OCTAVE; note++){
+        int min = occurrences.min[note], max = occurrences.max[note];
+        if(min == max)
+            count(home, currentChord, get_all_given_note_set(note), IRT_EQ, min);
+        else{
+            if(min > 0)
+                count(home, currentChord, get_all_given_note_set(note), IRT_GQ, min);
+            if(max < currentChord.size())
+                count(home, currentChord, get_all_given_note_set(note), IRT_LQ, max);
+        }
+    }
+    nvalues(home, currentChord, IRT_EQ, nOfValues);
+    nvalues(home, currentChordNotes, IRT_EQ, nOfNotes);
+}
@@ -0,0 +1,190 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator computing a lower bound on the cost of the melodic intervals from the domains of the notes
+//
+#include <climits>
+
+#include "../../headers/diatony/MelodicCostBound.hpp"
+
+/**
+ * Constructor for posting
+ * @param home the space
+ * @param notes the notes of the chord progression
+ * @param cost the cost of the melodic intervals
+ * @param voices the number of voices
+ */
+MelodicCostBound::MelodicCostBound(Home home, ViewArray<Int::IntView> &notes, Int::IntView cost, int voices) :
+        MixNaryOnePropagator<Int::IntView, Int::PC_INT_DOM, Int::IntView, Int::PC_INT_BND>(home, notes, cost),
+        nOfVoices(voices) {}
+
+/**
+ * Constructor for cloning
+ * @param home the space
+ * @param p the propagator to copy
+ */
+MelodicCostBound::MelodicCostBound(Space &home, MelodicCostBound &p) :
+        MixNaryOnePropagator<Int::IntView, Int::PC_INT_DOM, Int::IntView, Int::PC_INT_BND>(home, p),
+        nOfVoices(p.nOfVoices) {}
+
+/**
+ * Posts the propagator
+ * @param home the space
+ * @param notes the notes of the chord progression in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ * @param cost the cost of the melodic intervals
+ * @param voices the number of voices
+ * @return ES_OK
+ */
+ExecStatus MelodicCostBound::post(Home home, ViewArray<Int::IntView> &notes, Int::IntView cost, int voices) {
+    (void) new (home) MelodicCostBound(home, notes, cost, voices);
+    return ES_OK;
+}
+
+/**
+ * Copies the propagator during cloning
+ * @param home the space
+ * @return a copy of the propagator
+ */
+Propagator* MelodicCostBound::copy(Space &home) {
+    return new (home) MelodicCostBound(home, *this);
+}
+
+/**
+ * Returns the cost of the propagator: the shortest paths are quadratic in the size of the domains
+ * @param home the space
+ * @param med the modification events
+ * @return the cost of the propagator
+ */
+PropCost MelodicCostBound::cost(const Space &home, const ModEventDelta &med) const {
+    return PropCost::quadratic(PropCost::HI, x.size());
+}
+
+/**
+ * Returns the cost of a melodic interval, or INT_MAX if the interval is larger than an octave
+ * @param interval a melodic interval
+ * @return the cost of the interval
+ */
+static int interval_cost(int interval){
+    if(interval < -PERFECT_OCTAVE || interval > PERFECT_OCTAVE)
+        return INT_MAX;
+    return MELODIC_INTERVAL_COSTS[interval + PERFECT_OCTAVE];
+}
+
+/**
+ * Computes the cost of the cheapest melody of a voice ending on each candidate note of each chord
+ * @param voice the voice
+ * @param values the candidate notes of all the notes of the progression, one note after the other
+ * @param first the index in values of the first candidate of each note, followed by the number of candidates
+ * @param forward filled for the notes of the voice with the cost of the cheapest melody from the first chord to each
+ * candidate, indexed as values
+ * @param backward filled for the notes of the voice with the cost of the cheapest melody from each candidate to the last
+ * chord, indexed as values
+ * @return the cost of the cheapest melody of the voice, INT_MAX if the voice has no melody
+ */
+int MelodicCostBound::shortest_melody(int voice, const int* values, const int* first, int* forward,
+                                      int* backward) const {
+    int size = x.size() / nOfVoices;
+    int firstNote = voice, lastNote = (size - 1) * nOfVoices + voice;
+    for(int a = first[firstNote]; a < first[firstNote + 1]; a++)
+        forward[a] = 0;
+    for(int a = first[lastNote]; a < first[lastNote + 1]; a++)
+        backward[a] = 0;
+    for(int i = 1; i < size; i++){
+        int note = i * nOfVoices + voice, previous = note - nOfVoices;
+        for(int b = first[note]; b < first[note + 1]; b++){
+            forward[b] = INT_MAX;
+            for(int a = first[previous]; a < first[previous + 1]; a++){
+                int step = interval_cost(values[b] - values[a]);
+                if(forward[a] != INT_MAX && step != INT_MAX)
+                    forward[b] = min(forward[b], forward[a] + step);
+            }
+        }
+    }
+    for(int i = size - 2; i >= 0; i--){
+        int note = i * nOfVoices + voice, next = note + nOfVoices;
+        for(int a = first[note]; a < first[note + 1]; a++){
+            backward[a] = INT_MAX;
+            for(int b = first[next]; b < first[next + 1]; b++){
+                int step = interval_cost(values[b] - values[a]);
+                if(backward[b] != INT_MAX && step != INT_MAX)
+                    backward[a] = min(backward[a], backward[b] + step);
+            }
+        }
+    }
+    return *std::min_element(forward + first[lastNote], forward + first[lastNote + 1]);
+}
+
+/**
+ * Updates the lower bound of the cost with the sum of the cheapest melodies of each voice, then removes the notes
+ * through which the cheapest melody of their voice would make the total cost exceed the upper bound of the cost.
+ * Removing a note can make the melodies going through its neighbours more expensive, so the propagator is not
+ * idempotent when it removes notes.
+ * @param home the space
+ * @param med the modification events
+ * @return the status of the propagation
+ */
+ExecStatus MelodicCostBound::propagate(Space &home, const ModEventDelta &med) {
+    if(x.size() <= nOfVoices)       /// a single chord has no melodic interval
+        return home.ES_SUBSUMED(*this);
+
+    /// the propagator runs at every node, so its buffers are taken from the region of the space rather than the heap.
+    /// The candidates of note j are values[first[j]] to values[first[j + 1] - 1]
+    Region r;
+    int* first = r.alloc<int>(x.size() + 1);
+    first[0] = 0;
+    for(int j = 0; j < x.size(); j++)
+        first[j + 1] = first[j] + x[j].size();
+    int* values = r.alloc<int>(first[x.size()]);
+    int* forward = r.alloc<int>(first[x.size()]);
+    int* backward = r.alloc<int>(first[x.size()]);
+    for(int j = 0; j < x.size(); j++){
+        int k = first[j];
+        for(Int::ViewValues<Int::IntView> v(x[j]); v(); ++v)
+            values[k++] = v.val();
+    }
+
+    int* cheapest = r.alloc<int>(nOfVoices);
+    int lowerBound = 0;
+    for(int voice = 0; voice < nOfVoices; voice++){
+        cheapest[voice] = shortest_melody(voice, values, first, forward, backward);
+        if(cheapest[voice] == INT_MAX)
+            return ES_FAILED;
+        lowerBound += cheapest[voice];
+    }
+    GECODE_ME_CHECK(y.gq(home, lowerBound));
+
+    /// the extra cost that a voice can afford on top of its cheapest melody
+    int slack = y.max() - lowerBound;
+    bool modified = false;
+    for(int j = 0; j < x.size(); j++){
+        int voice = j % nOfVoices;
+        for(int a = first[j]; a < first[j + 1]; a++){
+            int through = forward[a];
+            if(through != INT_MAX && backward[a] != INT_MAX)
+                through += backward[a];
+            else
+                through = INT_MAX;
+            if(through == INT_MAX || through - cheapest[voice] > slack){
+                GECODE_ME_CHECK(x[j].nq(home, values[a]));
+                modified = true;
+            }
+        }
+    }
+    if(x.assigned())
+        return home.ES_SUBSUMED(*this);
+    return modified ? ES_NOFIX : ES_FIX;
+}
+
+/**
+ * Bounds the cost of the melodic intervals of all voices with a single MelodicCostBound propagator. It comes on top of
+ * the element constraints of compute_cost_for_melodic_intervals, which still define the cost of each interval.
+ * @param home the instance of the problem
+ * @param nOfVoices the number of voices
+ * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param costOfMelodicIntervals the cost of the melodic intervals (weighted sum)
+ */
+void melodic_cost_bound(Home home, int nOfVoices, const IntVarArray &fullChordsVoicing,
+                        const IntVar &costOfMelodicIntervals) {
+    GECODE_POST;
+    ViewArray<Int::IntView> notes(home, IntVarArgs(fullChordsVoicing));
+    GECODE_ES_FAIL(MelodicCostBound::post(home, notes, Int::IntView(costOfMelodicIntervals), nOfVoices));
+}
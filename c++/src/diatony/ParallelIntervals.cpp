@@ -0,0 +1,147 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A propagator forbidding parallel intervals between all the pairs of voices of two successive chords
+//
+#include "../../headers/diatony/ParallelIntervals.hpp"
+
+/**
+ * Constructor for posting
+ * @param home the space
+ * @param notes the notes of the two chords
+ * @param forbiddenIntervals the bit mask of the forbidden intervals modulo the octave
+ */
+ParallelIntervals::ParallelIntervals(Home home, ViewArray<Int::IntView> &notes, unsigned int forbiddenIntervals) :
+        NaryPropagator<Int::IntView, Int::PC_INT_VAL>(home, notes), forbidden(forbiddenIntervals) {}
+
+/**
+ * Constructor for cloning
+ * @param home the space
+ * @param p the propagator to copy
+ */
+ParallelIntervals::ParallelIntervals(Space &home, ParallelIntervals &p) :
+        NaryPropagator<Int::IntView, Int::PC_INT_VAL>(home, p), forbidden(p.forbidden) {}
+
+/**
+ * Returns whether a harmonic interval is forbidden. As in forbid_parallel_interval, the interval modulo the octave
+ * is compared to the forbidden ones
+ * @param interval a harmonic interval
+ * @return true if the interval is forbidden
+ */
+bool ParallelIntervals::is_forbidden(int interval) const {
+    int modulo = interval % PERFECT_OCTAVE;
+    return modulo >= 0 && (forbidden >> modulo) & 1U;
+}
+
+/**
+ * Returns whether two voices form the same forbidden interval in both chords
+ * @param lowerCurrent the note of the lower voice in the first chord
+ * @param upperCurrent the note of the upper voice in the first chord
+ * @param lowerNext the note of the lower voice in the second chord
+ * @param upperNext the note of the upper voice in the second chord
+ * @return true if the motion is forbidden
+ */
+bool ParallelIntervals::is_parallel(int lowerCurrent, int upperCurrent, int lowerNext, int upperNext) const {
+    if(lowerCurrent == lowerNext && upperCurrent == upperNext)
+        return false;
+    int currentInterval = upperCurrent - lowerCurrent;
+    int nextInterval = upperNext - lowerNext;
+    return currentInterval % PERFECT_OCTAVE == nextInterval % PERFECT_OCTAVE && is_forbidden(currentInterval);
+}
+
+/**
+ * Posts the propagator
+ * @param home the space
+ * @param notes the notes of the two chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ * @param forbiddenIntervals the bit mask of the forbidden intervals modulo the octave
+ * @return ES_OK. Notes that already form parallel intervals make the first propagation fail
+ */
+ExecStatus ParallelIntervals::post(Home home, ViewArray<Int::IntView> &notes, unsigned int forbiddenIntervals) {
+    (void) new (home) ParallelIntervals(home, notes, forbiddenIntervals);
+    return ES_OK;
+}
+
+/**
+ * Copies the propagator during cloning
+ * @param home the space
+ * @return a copy of the propagator
+ */
+Propagator* ParallelIntervals::copy(Space &home) {
+    return new (home) ParallelIntervals(home, *this);
+}
+
+/**
+ * Removes the values forming parallel intervals from the notes. The pairs of voices are checked until no more values
+ * can be removed, so the propagator is idempotent.
+ * @param home the space
+ * @param med the modification events
+ * @return the status of the propagation
+ */
+ExecStatus ParallelIntervals::propagate(Space &home, const ModEventDelta &med) {
+    int nOfVoices = x.size() / 2;
+    bool modified = true;
+    while(modified){
+        modified = false;
+        for(int lower = 0; lower < nOfVoices - 1; lower++){
+            for(int upper = lower + 1; upper < nOfVoices; upper++){
+                /// the notes of the pair: lower and upper voices in the first chord, then in the second one
+                int notes[4] = {lower, upper, nOfVoices + lower, nOfVoices + upper};
+                int unassigned = -1;
+                int nOfUnassigned = 0;
+                for(int i = 0; i < 4; i++){
+                    if(!x[notes[i]].assigned()){
+                        unassigned = i;
+                        nOfUnassigned++;
+                    }
+                }
+                if(nOfUnassigned > 1)
+                    continue;
+                int values[4];
+                for(int i = 0; i < 4; i++)
+                    values[i] = i == unassigned ? 0 : x[notes[i]].val();
+                if(nOfUnassigned == 0){
+                    if(is_parallel(values[0], values[1], values[2], values[3]))
+                        return ES_FAILED;
+                    continue;
+                }
+                /// remove the values of the last note that form a parallel interval. They are all congruent modulo the
+                /// octave, so there is at most one per octave of the domain
+                Int::IntView note = x[notes[unassigned]];
+                Region r;
+                int* parallelValues = r.alloc<int>((note.max() - note.min()) / PERFECT_OCTAVE + 1);
+                int nOfParallelValues = 0;
+                for(Int::ViewValues<Int::IntView> v(note); v(); ++v){
+                    values[unassigned] = v.val();
+                    if(is_parallel(values[0], values[1], values[2], values[3]))
+                        parallelValues[nOfParallelValues++] = v.val();
+                }
+                for(int k = 0; k < nOfParallelValues; k++)
+                    GECODE_ME_CHECK(note.nq(home, parallelValues[k]));
+                modified = modified || nOfParallelValues > 0;
+            }
+        }
+    }
+    return x.assigned() ? home.ES_SUBSUMED(*this) : ES_FIX;
+}
+
+/**
+ * Forbids a list of parallel intervals between all pairs of voices when moving from the chord at currentPosition to
+ * the next one, with a single ParallelIntervals propagator
+ * @param home the instance of the problem
+ * @param currentPosition the current position in the chord progression
+ * @param nOfVoices the number of voices
+ * @param intervals the list of intervals to forbid
+ * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ */
+void parallel_intervals(Home home, int currentPosition, int nOfVoices, const vector<int> &intervals,
+                        const IntVarArray &fullChordsVoicing) {
+    GECODE_POST;
+    unsigned int forbiddenIntervals = 0;
+    for(int interval : intervals)
+        if(interval >= 0 && interval < PERFECT_OCTAVE)   /// larger intervals never match an interval modulo the octave
+            forbiddenIntervals |= 1U << interval;
+    IntVarArgs notes;
+    for(int i = currentPosition * nOfVoices; i < (currentPosition + 2) * nOfVoices; i++)
+        notes << fullChordsVoicing[i];
+    ViewArray<Int::IntView> views(home, notes);
+    GECODE_ES_FAIL(ParallelIntervals::post(home, views, forbiddenIntervals));
+}
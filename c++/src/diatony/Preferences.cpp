@@ -9,22 +9,20 @@
  * and an array containing the number of different notes in each diminished chord (other chords are set to 0).
  * Here, the preference is that they should be used in 3 voices instead of 4.
  * @param home the instance of the problem
- * @param nVoices the number of voices
  * @param size the number of chords
  * @param chordStates the state of the chord (inversion)
  * @param chordQualities the quality of the chord (diminished, minor, major, augmented,...)
- * @param fullChordsVoicing the array containing all the chords in the form
- *          [bass0, alto0, tenor0, soprano0, bass1, alto1, tenor1, soprano1, ...]
+ * @param nOfDifferentValues the array containing the number of different values in each chord
  * @param nOfDifferentNotes the array containing the number of different notes in each diminished chord.
  * @param costVar the variable that will contain the number of diminished chords that don't respect the preference
  */
-void compute_diminished_chords_cost(const Home &home, int nVoices, int size, vector<int> chordStates,
-                                    vector<int> chordQualities, IntVarArray fullChordsVoicing,
-                                    IntVarArray nOfDifferentNotes, const IntVar &costVar) {
+void compute_diminished_chords_cost(const Home &home, int size, vector<int> chordStates, vector<int> chordQualities,
+                                    IntVarArray nOfDifferentValues, IntVarArray nOfDifferentNotes,
+                                    const IntVar &costVar) {
     for(int i = 0; i < size; ++i){
         if(chordQualities[i] == DIMINISHED_CHORD && chordStates[i] == FUNDAMENTAL_STATE){
-            IntVarArgs currentChord(fullChordsVoicing.slice(nVoices * i, 1, nVoices));
-            nvalues(home, currentChord, IRT_EQ, nOfDifferentNotes[i]);
+            /// the different values of the chord are already counted for all chords
+            rel(home, nOfDifferentNotes[i], IRT_EQ, nOfDifferentValues[i]);
         }
         else{ /// doesn't matter so is set to 0 to be ignored
             rel(home, nOfDifferentNotes[i], IRT_EQ, 0);
@@ -38,19 +36,10 @@ void compute_diminished_chords_cost(const Home &home, int nVoices, int size, vec
  * Computes the cost for the number of notes in a chord, that is the number of chords that have less than 4 different
  * values
  * @param home the instance of the problem
- * @param nVoices the number of voices
- * @param size the size of the chord
- * @param tonality the tonality of the piece
- * @param fullChordsVoicing the array containing all the chords in the form [bass, alto, tenor, soprano]
  * @param nOfDifferentNotes the array containing the number of different notes in each chord
  * @param costVar the variable that will contain the cost
  */
-void compute_n_of_notes_in_chord_cost(const Home &home, int nVoices, int size, IntVarArray fullChordsVoicing,
-                                      IntVarArray nOfDifferentNotes, const IntVar &costVar) {
-    for(int i = 0; i < size; i++) {
-        IntVarArgs currentChord(fullChordsVoicing.slice(nVoices * i, 1, nVoices));
-        nvalues(home, currentChord, IRT_EQ,nOfDifferentNotes[i]);
-    }
+void compute_n_of_notes_in_chord_cost(const Home &home, const IntVarArray &nOfDifferentNotes, const IntVar &costVar) {
     /// costVar = nb of vars in nOfDifferentNotes that are smaller than 4
     count(home, nOfDifferentNotes, IntSet({1,2,3}), IRT_EQ, costVar);
 }
@@ -58,25 +47,14 @@ void compute_n_of_notes_in_chord_cost(const Home &home, int nVoices, int size, I
 /**
  * This function counts the number of incomplete chords
  * @param home the instance of the problem
- * @param nVoices the number of voices in the chords
  * @param size the number of chords in the chord progression
  * @param nNotesInChords the number of notes in each chord if it is complete
- * @param fullChordsVoicing all the notes of all the chords
  * @param nDiffNotesInChord An IntVarArray counting the number of different notes (regardless of their octave) in
  * each chord
  * @param nOfIncompleteChords an IntVar counting the number of incomplete chords in the chord progression
  */
-void compute_cost_for_incomplete_chords(const Home &home, int nVoices, int size, const IntArgs &nNotesInChords,
-                                        IntVarArray fullChordsVoicing, IntVarArray nDiffNotesInChord,
-                                        const IntVar &nOfIncompleteChords) {
-    for(int i = 0; i < size; i++) {
-        IntVarArgs currentChord(fullChordsVoicing.slice(nVoices * i, 1, nVoices));
-        /// note values regardless of their octave
-        IntVarArgs currentChordNotes;
-        for(int j = 0; j < nVoices; j++)
-            currentChordNotes << expr(home, currentChord[j] % PERFECT_OCTAVE);
-        nvalues(home, currentChordNotes, IRT_EQ,nDiffNotesInChord[i]);
-    }
+void compute_cost_for_incomplete_chords(const Home &home, int size, const IntArgs &nNotesInChords,
+                                        const IntVarArray &nDiffNotesInChord, const IntVar &nOfIncompleteChords) {
     /// count the number of incomplete chords (size - the number of chords that have the max amount of notes)
     count(home, nDiffNotesInChord, nNotesInChords, IRT_EQ, expr(home, size - nOfIncompleteChords));
 }
@@ -129,18 +107,8 @@ void
 compute_cost_for_melodic_intervals(const Home &home, const IntVarArray &allMelodicIntervals, const IntVar &nOfUnissons,
                                    const IntVar &costOfMelodicIntervals, IntVarArray costAllMelodicIntervals) {
 
-    ///                    -octave,     - major seventh,    - minor seventh,    - major sixth,  - minor sixth,
-    IntArgs weights({   OCTAVE_COST, SEVENTH_COST,       SEVENTH_COST,       SIXTH_COST,     SIXTH_COST,
-    ///                     -perfect fifth,     - tritone,      -perfect fourth,    - major third,  - minor third,
-                            FIFTH_COST,         TRITONE_COST,   FOURTH_COST,        THIRD_COST,     THIRD_COST,
-    ///                     - major second,     - minor second,     unison,
-                            SECOND_COST,        SECOND_COST,        UNISON_COST,
-    ///                     minor second,   major second,   minor third,    major third,    perfect fourth,
-                            SECOND_COST,    SECOND_COST,    THIRD_COST,     THIRD_COST,     FOURTH_COST,
-    ///                     tritone,        perfect fifth,  minor sixth,    major sixth,    minor seventh,
-                            TRITONE_COST,   FIFTH_COST,     SIXTH_COST,     SIXTH_COST,     SEVENTH_COST,
-    ///                     major seventh,  octave
-                            SEVENTH_COST,   OCTAVE_COST});
+    /// weights of the intervals, indexed by interval + PERFECT_OCTAVE
+    IntArgs weights(MELODIC_INTERVAL_COSTS);
 
     for(int i = 0; i < allMelodicIntervals.size(); i++){
         element(home, weights, expr(home, allMelodicIntervals[i] + PERFECT_OCTAVE), costAllMelodicIntervals[i]); // so indexes are [0,24] instead of [-12,12]
@@ -0,0 +1,90 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A cache of solved progressions that serves the same progression in other keys by transposition.
+//
+#include <algorithm>
+#include <tuple>
+
+#include "../../headers/diatony/ProgressionCache.hpp"
+
+/**
+ * Compares two progressions in lexicographical order of their fields
+ * @param other another progression
+ * @return true if this progression comes before the other one
+ */
+bool ProgressionKey::operator<(const ProgressionKey &other) const {
+    return std::tie(mode, chords, qualities, states) <
+           std::tie(other.mode, other.chords, other.qualities, other.states);
+}
+
+/**
+ * Transposes a voicing by the smallest shift that brings the tonic of a key to another one, up or down, while
+ * keeping every voice in its range
+ * @param voicing the notes of the progression in the form [bass0, tenor0, alto0, soprano0, bass1, ...]
+ * @param fromTonic the tonic of the key of the voicing
+ * @param toTonic the tonic of the target key
+ * @param transposed filled with the transposed voicing. If no transposition keeps the voices in their ranges,
+ * it is transposed by the smallest shift
+ * @return true if a transposition keeps all the voices in their ranges
+ */
+bool ProgressionCache::transpose(const vector<int> &voicing, int fromTonic, int toTonic, vector<int> &transposed) {
+    const vector<int> lowerBounds = {BASS_MIN, TENOR_MIN, ALTO_MIN, SOPRANO_MIN};
+    const vector<int> upperBounds = {BASS_MAX, TENOR_MAX, ALTO_MAX, SOPRANO_MAX};
+    int up = ((toTonic - fromTonic) % PERFECT_OCTAVE + PERFECT_OCTAVE) % PERFECT_OCTAVE;
+    /// try the smallest shift first
+    vector<int> shifts = up <= PERFECT_OCTAVE - up ? vector<int>{up, up - PERFECT_OCTAVE} :
+                                                    vector<int>{up - PERFECT_OCTAVE, up};
+    for(int shift : shifts){
+        bool inRange = true;
+        for(int i = 0; i < voicing.size() && inRange; i++)
+            inRange = voicing[i] + shift >= lowerBounds[i % 4] && voicing[i] + shift <= upperBounds[i % 4];
+        transposed.clear();
+        for(int note : voicing)
+            transposed.push_back(note + (inRange ? shift : shifts[0]));
+        if(inRange)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the solutions of a progression
+ * @param key the key independent form of the progression
+ * @return the solutions of the progression, one per key it was solved in, optimal solutions first
+ */
+vector<SolvedProgression> ProgressionCache::get(const ProgressionKey &key) const {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = solutions.find(key);
+    if(it == solutions.end())
+        return {};
+    vector<SolvedProgression> solved = it->second;
+    std::stable_partition(solved.begin(), solved.end(), [](const SolvedProgression &s){ return s.optimal; });
+    return solved;
+}
+
+/**
+ * Adds the solution of a progression in a key. It replaces the previous solution in that key if it is better
+ * @param key the key independent form of the progression
+ * @param solution the solution
+ */
+void ProgressionCache::add(const ProgressionKey &key, const SolvedProgression &solution) {
+    std::lock_guard<std::mutex> guard(lock);
+    vector<SolvedProgression> &solved = solutions[key];
+    for(auto &s : solved){
+        if(s.tonic == solution.tonic){
+            if(solution.costs < s.costs || (solution.costs == s.costs && solution.optimal))
+                s = solution;
+            return;
+        }
+    }
+    solved.push_back(solution);
+}
+
+/**
+ * Returns the number of progressions in the cache
+ * @return the number of key independent progressions solved at least once
+ */
+int ProgressionCache::get_size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return solutions.size();
+}
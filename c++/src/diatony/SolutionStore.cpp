@@ -0,0 +1,294 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A persistent store of the best solutions found for each problem, kept in a memory-mapped,
+//                append-only file so that it survives restarts and can be shared by several processes.
+//
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../headers/diatony/SolutionStore.hpp"
+
+/** The first bytes of a solution store file */
+static const char STORE_MAGIC[8] = {'D', 'I', 'A', 'T', 'O', 'N', 'Y', '2'};
+/** The size of the file header: the magic bytes followed by the number of bytes used in the file */
+static const uint64_t STORE_HEADER_SIZE = 16;
+/** The initial size of the file */
+static const size_t STORE_INITIAL_SIZE = 1 << 16;
+
+/**
+ * The fixed part of a record. It is followed by the chords, the qualities and the states of the problem, the costs and
+ * the voicing of the solution, all as 32 bits integers, and padded to a multiple of 8 bytes.
+ */
+struct StoreRecord {
+    uint64_t    hash;                                                       // the hash of the problem
+    uint32_t    length;                                                     // the length of the record in bytes
+    int32_t     optimal;                                                    // 1 if the solution is proven optimal
+    int32_t     modelVersion;                                               // the version of the model of the solution
+    int32_t     tonic;                                                      // the tonic of the tonality
+    int32_t     mode;                                                       // the mode of the tonality
+    int32_t     size;                                                       // the number of chords
+    int32_t     nOfCosts;                                                   // the number of costs
+};
+
+/**
+ * Holds an exclusive lock on a file for as long as it exists, so that only one process writes in the store at a time
+ */
+struct FileLock {
+    int file;
+    explicit FileLock(int f) : file(f) { flock(file, LOCK_EX); }
+    ~FileLock() { flock(file, LOCK_UN); }
+};
+
+/**
+ * Returns the hash of the canonical form of the problem (64 bits FNV-1a)
+ * @return the hash of the problem
+ */
+uint64_t StoredProblem::hash() const {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](int value){
+        for(int i = 0; i < 4; i++){
+            h ^= (uint64_t) ((value >> (8 * i)) & 0xFF);
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(tonic);
+    mix(mode);
+    mix(chords.size());
+    for(int c : chords)     mix(c);
+    for(int q : qualities)  mix(q);
+    for(int s : states)     mix(s);
+    return h;
+}
+
+/**
+ * Returns the 32 bits integers following the fixed part of a record
+ * @param record a record
+ * @return a pointer to the chords of the record
+ */
+static const int32_t* record_values(const StoreRecord* record){
+    return reinterpret_cast<const int32_t*>(record + 1);
+}
+
+/**
+ * Checks whether a record stores a given problem
+ * @param record a record
+ * @param problem a problem
+ * @return true if the record stores the problem
+ */
+static bool record_matches(const StoreRecord* record, const StoredProblem &problem){
+    int size = problem.chords.size();
+    if(record->tonic != problem.tonic || record->mode != problem.mode || record->size != size)
+        return false;
+    const int32_t* values = record_values(record);
+    return std::equal(problem.chords.begin(), problem.chords.end(), values) &&
+           std::equal(problem.qualities.begin(), problem.qualities.end(), values + size) &&
+           std::equal(problem.states.begin(), problem.states.end(), values + 2 * size);
+}
+
+/**
+ * Returns the number of bytes used in the file, as published by the last append
+ * @param data the mapped file
+ * @return the number of bytes used
+ */
+static uint64_t used_bytes(const char* data){
+    return __atomic_load_n(reinterpret_cast<const uint64_t*>(data + sizeof(STORE_MAGIC)), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Constructor. Opens the store, creating the file if it does not exist
+ * @param path the path of the file
+ * @throws std::runtime_error if the file cannot be opened, is not a solution store or is corrupted
+ */
+SolutionStore::SolutionStore(const string &path) : data(nullptr), capacity(0), indexed(STORE_HEADER_SIZE) {
+    file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(file < 0)
+        throw std::runtime_error("Cannot open the solution store " + path);
+    try{
+        FileLock fileLock(file);    /// another process may be creating the file
+        struct stat info;
+        fstat(file, &info);
+        bool created = info.st_size == 0;
+        map_file(created ? STORE_INITIAL_SIZE : max((size_t) info.st_size, (size_t) STORE_HEADER_SIZE));
+        if(created){
+            memcpy(data, STORE_MAGIC, sizeof(STORE_MAGIC));
+            __atomic_store_n(reinterpret_cast<uint64_t*>(data + sizeof(STORE_MAGIC)), STORE_HEADER_SIZE,
+                             __ATOMIC_RELEASE);
+        }
+    }
+    catch(...){
+        close(file);
+        throw;
+    }
+    if(memcmp(data, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0){
+        munmap(data, capacity);
+        close(file);
+        throw std::runtime_error(path + " is not a solution store");
+    }
+    refresh();
+}
+
+/**
+ * Destructor. Unmaps and closes the file
+ */
+SolutionStore::~SolutionStore() {
+    munmap(data, capacity);
+    close(file);
+}
+
+/**
+ * Maps the whole file in memory, growing it to at least a given size
+ * @param minSize the minimum size of the file in bytes
+ */
+void SolutionStore::map_file(size_t minSize) const {
+    struct stat info;
+    fstat(file, &info);
+    size_t size = info.st_size;
+    if(size < minSize){
+        if(ftruncate(file, minSize) != 0)
+            throw std::runtime_error("Cannot grow the solution store");
+        size = minSize;
+    }
+    if(data != nullptr)
+        munmap(data, capacity);
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if(mapped == MAP_FAILED)
+        throw std::runtime_error("Cannot map the solution store in memory");
+    data = static_cast<char*>(mapped);
+    capacity = size;
+}
+
+/**
+ * Indexes the records appended since the last call, remapping the file if another process has grown it
+ * @throws std::runtime_error if a record does not fit in the bytes used in the file
+ */
+void SolutionStore::refresh() const {
+    uint64_t used = used_bytes(data);
+    if(used == indexed)
+        return;
+    if(used > capacity)
+        map_file(used);
+    while(indexed < used){
+        /// the record must hold its fixed part and all its values, and end before the bytes used in the file
+        auto record = reinterpret_cast<const StoreRecord*>(data + indexed);
+        if(used - indexed < sizeof(StoreRecord) || record->length < sizeof(StoreRecord) ||
+           record->length > used - indexed || record->size < 0 || record->nOfCosts < 0 ||
+           sizeof(StoreRecord) + (7 * (uint64_t) record->size + record->nOfCosts) * sizeof(int32_t) > record->length)
+            throw std::runtime_error("The solution store is corrupted");
+        const int32_t* values = record_values(record);
+        StoredProblem problem = {record->tonic, record->mode,
+                                 vector<int>(values, values + record->size),
+                                 vector<int>(values + record->size, values + 2 * record->size),
+                                 vector<int>(values + 2 * record->size, values + 3 * record->size)};
+        /// a later record of a problem replaces the earlier ones
+        bool replaced = false;
+        auto range = index.equal_range(record->hash);
+        for(auto it = range.first; it != range.second && !replaced; ++it){
+            if(record_matches(reinterpret_cast<const StoreRecord*>(data + it->second), problem)){
+                it->second = indexed;
+                replaced = true;
+            }
+        }
+        if(!replaced)
+            index.emplace(record->hash, indexed);
+        indexed += record->length;
+    }
+}
+
+/**
+ * Returns the offset of the latest record of a problem
+ * @param problem the problem
+ * @return the offset of the record, 0 if the problem is not in the store
+ */
+uint64_t SolutionStore::find(const StoredProblem &problem) const {
+    auto range = index.equal_range(problem.hash());
+    for(auto it = range.first; it != range.second; ++it)
+        if(record_matches(reinterpret_cast<const StoreRecord*>(data + it->second), problem))
+            return it->second;
+    return 0;
+}
+
+/**
+ * Looks a problem up in the store
+ * @param problem the problem
+ * @param solution filled with the best solution stored for the problem
+ * @return true if the problem is in the store
+ * @throws std::runtime_error if the store is corrupted
+ */
+bool SolutionStore::get(const StoredProblem &problem, StoredSolution &solution) const {
+    std::lock_guard<std::mutex> guard(lock);
+    refresh();
+    uint64_t offset = find(problem);
+    if(offset == 0)
+        return false;
+    auto record = reinterpret_cast<const StoreRecord*>(data + offset);
+    const int32_t* costs = record_values(record) + 3 * record->size;
+    const int32_t* voicing = costs + record->nOfCosts;
+    solution.costs.assign(costs, costs + record->nOfCosts);
+    solution.voicing.assign(voicing, voicing + 4 * record->size);
+    solution.optimal = record->optimal != 0;
+    solution.modelVersion = record->modelVersion;
+    return true;
+}
+
+/**
+ * Appends a solution of a problem to the store if it is better than the stored one, or as good but proven optimal,
+ * or if the stored one was found with another version of the model
+ * @param problem the problem
+ * @param solution the solution
+ * @return true if the solution was appended
+ * @throws std::runtime_error if the store is corrupted
+ */
+bool SolutionStore::add(const StoredProblem &problem, const StoredSolution &solution) {
+    std::lock_guard<std::mutex> guard(lock);
+    FileLock fileLock(file);        /// one writer at a time across processes
+    refresh();
+    uint64_t offset = find(problem);
+    if(offset != 0){
+        auto stored = reinterpret_cast<const StoreRecord*>(data + offset);
+        const int32_t* costs = record_values(stored) + 3 * stored->size;
+        vector<int> storedCosts(costs, costs + stored->nOfCosts);
+        /// the costs of two versions of the model cannot be compared, so the new solution replaces the stored one
+        if(stored->modelVersion == solution.modelVersion &&
+           (stored->optimal || storedCosts < solution.costs || (storedCosts == solution.costs && !solution.optimal)))
+            return false;
+    }
+
+    int size = problem.chords.size();
+    size_t nOfValues = 3 * size + solution.costs.size() + solution.voicing.size();
+    uint32_t length = (sizeof(StoreRecord) + nOfValues * sizeof(int32_t) + 7) & ~7u;
+    uint64_t used = used_bytes(data);
+    if(used + length > capacity)
+        map_file(max((size_t) (used + length), 2 * capacity));
+
+    /// the record is written before the header is updated, so readers never see a partial record
+    auto record = reinterpret_cast<StoreRecord*>(data + used);
+    memset(record, 0, length);
+    *record = {problem.hash(), length, solution.optimal ? 1 : 0, solution.modelVersion, problem.tonic, problem.mode,
+               size, (int32_t) solution.costs.size()};
+    int32_t* values = reinterpret_cast<int32_t*>(record + 1);
+    values = std::copy(problem.chords.begin(), problem.chords.end(), values);
+    values = std::copy(problem.qualities.begin(), problem.qualities.end(), values);
+    values = std::copy(problem.states.begin(), problem.states.end(), values);
+    values = std::copy(solution.costs.begin(), solution.costs.end(), values);
+    std::copy(solution.voicing.begin(), solution.voicing.end(), values);
+    __atomic_store_n(reinterpret_cast<uint64_t*>(data + sizeof(STORE_MAGIC)), used + length, __ATOMIC_RELEASE);
+    refresh();
+    return true;
+}
+
+/**
+ * Returns the number of problems in the store
+ * @return the number of distinct problems
+ */
+int SolutionStore::get_size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    refresh();
+    return index.size();
+}
@@ -3,63 +3,136 @@
 //
 
 #include <utility>
+#include <thread>
+#include <atomic>
 
 #include "../../headers/diatony/SolveDiatony.hpp"
+#include "../../headers/aux/WorkStealingPool.hpp"
 
 /**
- * Finds an optimal solution for a four voice texture problem and returns the list of all intermediate solutions found
- * during search
+ * Returns the cutoff of the restart based searches: restarts after a linear number of failures, merged with a geometric
+ * sequence starting at the square of the number of notes
+ * @param size the number of chords of the problem
+ * @return the cutoff, to be given to the options of a search
+ */
+Search::Cutoff* restart_cutoff(int size){
+    int nOfNotes = 4 * size;
+    return Search::Cutoff::merge(
+            Search::Cutoff::linear(2*size),
+            Search::Cutoff::geometric(nOfNotes * nOfNotes, 2));
+}
+
+/**
+ * Computes the lower bound of each cost of a solution, given that the costs before it are equal to the ones of the
+ * solution. The bounds are obtained by propagation on a copy of the root space, after posting the equalities one cost
+ * at a time. A solution whose cost meets its bound cannot be improved on that cost by any solution with the same
+ * earlier costs.
+ * @param root the problem after the initial propagation
+ * @param costs the cost vector of the solution
+ * @return the lower bound of each cost
+ */
+vector<int> cost_bounds(FourVoiceTexture* root, const vector<int> &costs){
+    vector<int> bounds(costs);
+    auto space = (FourVoiceTexture*) root->clone();
+    IntVarArgs costVector = space->get_cost_vector();
+    for(int i = 0; i < costVector.size(); i++){
+        if(space->status() == SS_FAILED)
+            break;
+        bounds[i] = costVector[i].min();
+        rel(*space, costVector[i], IRT_EQ, costs[i]);
+    }
+    delete space;
+    return bounds;
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem and streams every improving solution found during search
+ * to a callback. No solution is kept: the callback copies the ones it needs. The search stops as soon as the melodic
+ * cost of a solution meets its lower bound given the costs before it (see cost_bounds). If print is true, the gap
+ * between the melodic cost of each solution and that bound is reported.
  * @param size the number of chords
  * @param tonality the tonality of the piece
  * @param chords the chord degrees of the progression
  * @param qualities the qualities of the chords
  * @param states the states of the chords
+ * @param onSolution the callback called for each improving solution (see SolutionCallback)
  * @param print
- * @return A vector<FourVoiceTexture*> representing all the solutions found during search. If no solutions are found,
- * returns an empty vector. If the best solution is not found within the time limit, returns all solutions found so far.
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was neither stopped by the time limit, nor by the callback,
+ * nor cancelled, or if it stopped on a solution whose costs all meet their bounds
+ * @param options the branching options of the problem, for example a hint to start from
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search. The
+ * time spent in pause does not count in the time limit
+ * @return the number of solutions found
  */
-vector<FourVoiceTexture *>
-solve_diatony_problem(int size, Tonality *tonality, vector<int> chords, vector<int> qualities, vector<int> states, bool print) {
+int solve_diatony_problem_stream(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                 vector<int> states, const SolutionCallback &onSolution, bool print, double timeLimit,
+                                 bool* complete, const FourVoiceTextureOptions &options, CancellationToken* token){
     /// create a new problem
-    auto pb = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities), std::move(states));
+    FourVoiceTexture* pb = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities),
+                                                std::move(states), options);
+    /// kept after the initial propagation to compute the bounds of the costs of each solution
+    pb->status();
     /// Search options
+    CancellableStop stop(timeLimit, token);
     Search::Options opts;
     opts.threads = 1;
-    opts.stop = Search::Stop::time(60000); // stop after 120 seconds
-    opts.cutoff = Search::Cutoff::merge(
-            Search::Cutoff::linear(2*size),
-            Search::Cutoff::geometric((4*size)^2, 2));
+    opts.stop = &stop;
+    opts.cutoff = restart_cutoff(size);
     opts.nogoods_limit = size * 4 * 4;
 
     //DFS<FourVoiceTexture> solver(pb, opts);
     /// Restart based solver
     RBS<FourVoiceTexture, BAB> solver(pb, opts);
-    delete pb;
-
-    vector<FourVoiceTexture*> solutions;
 
     int n_sols = 0;
+    bool interrupted = false;
+    bool boundReached = false;      /// the melodic cost of the last solution meets its bound
+    bool proven = false;            /// every cost of the last solution meets its bound
+    string lastSolution;    /// only kept to print it at the end of the search
     auto start = std::chrono::high_resolution_clock::now();     /// start time
     /// Find all solutions
+    /// a pause blocks inside the stop object, so the engine only returns nullptr once the search is over
     while(FourVoiceTexture* next_sol = solver.next()){
         n_sols++;
+        vector<int> costs = intVarArgs_to_int_vector(next_sol->get_cost_vector());
+        vector<int> bounds = cost_bounds(pb, costs);
+        boundReached = costs[MELODIC_INTERVALS_COST] == bounds[MELODIC_INTERVALS_COST];
+        proven = costs == bounds;
         if (print) {
+            lastSolution = next_sol->to_string();
             std::cout << "temporary solution found (" << n_sols  << ")" << std::endl;
-            std::cout << next_sol->to_string() << std::endl;
+            std::cout << lastSolution << std::endl;
             std::cout << statistics_to_string(solver.statistics()) << std::endl;
+            std::cout << "optimality gap of the melodic cost: "
+                      << costs[MELODIC_INTERVALS_COST] - bounds[MELODIC_INTERVALS_COST]
+                      << " (lower bound " << bounds[MELODIC_INTERVALS_COST] << ")" << std::endl;
         }
-        solutions.push_back((FourVoiceTexture*) next_sol->copy());
+        interrupted = !onSolution(*next_sol, costs);
         delete next_sol;
+        /// no solution with the same earlier costs has a smaller melodic cost, so the search stops there
+        if(interrupted || boundReached)
+            break;
     }
+    delete pb;
     /// Give info on the search (complete, optimal, etc)
+    if(complete != nullptr)
+        *complete = !interrupted && (boundReached ? proven : !solver.stopped());
 
     auto currTime = std::chrono::high_resolution_clock::now();     /// current time
     std::chrono::duration<double> duration = currTime - start;
     if (print) {
         std::cout << "search over" << std::endl;
-        if(solver.stopped()){
+        if(token != nullptr && token->is_cancelled())
+            std::cout << "Search cancelled" << std::endl;
+        if(boundReached && !proven){
+            std::cout << "Melodic cost at its lower bound, search stopped. Current best solution found: " << std::endl;
+            std::cout << lastSolution << std::endl;
+            std::cout << statistics_to_string(solver.statistics()) << std::endl;
+        }
+        else if((solver.stopped() || interrupted) && !boundReached){
             std::cout << "Best solution not found within the time limit. Current best solution found: " << std::endl;
-            std::cout << solutions[n_sols-1]->to_string() << std::endl;
+            std::cout << lastSolution << std::endl;
             std::cout << statistics_to_string(solver.statistics()) << std::endl;
         }
         else if(n_sols == 0){
@@ -67,14 +140,965 @@ solve_diatony_problem(int size, Tonality *tonality, vector<int> chords, vector<i
         }
         else{
             std::cout << "Best solution found" << std::endl;
-            std::cout << solutions[n_sols-1]->to_string() << std::endl;
+            std::cout << lastSolution << std::endl;
             std::cout << statistics_to_string(solver.statistics()) << std::endl;
         }
         std::cout << "time taken: " << duration.count() << " seconds and " << n_sols << " solutions found.\n" << std::endl;
     }
+    return n_sols;
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem and returns the list of all intermediate solutions found
+ * during search
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was not stopped by the time limit
+ * @param options the branching options of the problem, for example a hint to start from
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search
+ * @return A vector<FourVoiceTexture*> representing all the solutions found during search, owned by the caller. If no
+ * solutions are found, returns an empty vector. If the best solution is not found within the time limit, returns all
+ * solutions found so far.
+ */
+vector<FourVoiceTexture *>
+solve_diatony_problem(int size, Tonality *tonality, vector<int> chords, vector<int> qualities, vector<int> states, bool print,
+                      double timeLimit, bool* complete, const FourVoiceTextureOptions &options,
+                      CancellationToken* token) {
+    vector<FourVoiceTexture*> solutions;
+    solve_diatony_problem_stream(size, tonality, std::move(chords), std::move(qualities), std::move(states),
+                                 [&solutions](FourVoiceTexture &sol, const vector<int> &costs){
+                                     solutions.push_back((FourVoiceTexture*) sol.copy());
+                                     return true;
+                                 }, print, timeLimit, complete, options, token);
     return solutions;
 }
 
+/**
+ * Finds an optimal solution for a four voice texture problem, keeping only the best solution found during search
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was not stopped by the time limit
+ * @param options the branching options of the problem, for example a hint to start from
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+static FourVoiceTexture* solve_for_best(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                        vector<int> states, bool print, double timeLimit, bool* complete,
+                                        const FourVoiceTextureOptions &options = FourVoiceTextureOptions(),
+                                        CancellationToken* token = nullptr){
+    FourVoiceTexture* best = nullptr;
+    solve_diatony_problem_stream(size, tonality, std::move(chords), std::move(qualities), std::move(states),
+                                 [&best](FourVoiceTexture &sol, const vector<int> &costs){
+                                     delete best;
+                                     best = (FourVoiceTexture*) sol.copy();
+                                     return true;
+                                 }, print, timeLimit, complete, options, token);
+    return best;
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem, reusing the solutions of the same progression in other
+ * keys. If the progression was solved in another key, its solution is transposed and checked against the model. If
+ * the transposed solution leaves the ranges of the voices or violates the model, the problem is solved with the
+ * transposed solution as a hint. The solution found is added to the cache.
+ * @param cache the solutions of the progressions solved so far
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds, if a search is needed
+ * @param complete if not nullptr, set to true if the solution comes from a search in this key that was not stopped by
+ * the time limit. A solution transposed from another key is never reported as optimal: the ranges of the voices do not
+ * move with the key, so other voicings may be better in this key
+ * @param token if not nullptr, the token through which another thread can cancel, pause and resume the search, if a
+ * search is needed
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_cached(ProgressionCache &cache, int size, Tonality* tonality, vector<int> chords,
+                                               vector<int> qualities, vector<int> states, bool print,
+                                               double timeLimit, bool* complete, CancellationToken* token){
+    ProgressionKey key = {tonality->get_mode(), chords, qualities, states};
+    int tonic = tonality->get_tonic();
+    FourVoiceTextureOptions options;
+
+    for(const SolvedProgression &solved : cache.get(key)){
+        vector<int> voicing;
+        bool inRange = ProgressionCache::transpose(solved.voicing, solved.tonic, tonic, voicing);
+        /// the first transposed solution is the hint of the search if no transposed solution is valid. The value
+        /// selection takes the closest note in the ranges when the hint leaves them
+        if(options.hint.empty())
+            options.hint = voicing;
+        if(!inRange)
+            continue;
+        FourVoiceTexture* sol = new FourVoiceTexture(size, tonality, chords, qualities, states);
+        sol->fix_voicing(voicing);
+        if(sol->status() != SS_FAILED){
+            /// the optimality of a solution is only known in the key it was searched in
+            bool optimal = solved.optimal && solved.tonic == tonic;
+            if(solved.tonic != tonic)
+                cache.add(key, {tonic, voicing, intVarArgs_to_int_vector(sol->get_cost_vector()), false});
+            if(complete != nullptr)
+                *complete = optimal;
+            if(print){
+                std::cout << "Solution transposed from " << midi_to_letter(solved.tonic) << std::endl;
+                std::cout << sol->to_string() << std::endl;
+            }
+            return sol;
+        }
+        delete sol;
+    }
+
+    /// not in the cache, or no transposition is valid in this key: search, starting from the hint if there is one
+    bool searchComplete = false;
+    FourVoiceTexture* sol = solve_for_best(size, tonality, chords, qualities, states, print, timeLimit,
+                                           &searchComplete, options, token);
+    if(complete != nullptr)
+        *complete = searchComplete;
+    if(sol == nullptr)
+        return nullptr;
+    cache.add(key, {tonic, intVarArgs_to_int_vector(sol->getFullVoicing()),
+                    intVarArgs_to_int_vector(sol->get_cost_vector()), searchComplete});
+    return sol;
+}
+
+/**
+ * Harmonizes a batch of progressions concurrently on a work stealing thread pool. Each job is solved with
+ * solve_diatony_problem within its own time budget, or with solve_diatony_problem_cached if a cache is given.
+ * @param jobs the progressions to harmonize
+ * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+ * @param cache if not nullptr, the cache used to share the solutions of the same progression in different keys
+ * @return the results in the same order as the jobs
+ */
+vector<DiatonyResult> solve_diatony_batch(const vector<DiatonyJob> &jobs, int nOfThreads, ProgressionCache* cache){
+    vector<DiatonyResult> results(jobs.size());
+    WorkStealingPool pool(nOfThreads);
+    for(int i = 0; i < jobs.size(); i++){
+        pool.submit([&jobs, &results, cache, i](){
+            const DiatonyJob &job = jobs[i];
+            DiatonyResult &result = results[i];
+            auto start = std::chrono::high_resolution_clock::now();     /// start time
+            if(job.token != nullptr && job.token->is_cancelled())
+                return;
+            if(cache != nullptr){
+                FourVoiceTexture* sol = solve_diatony_problem_cached(*cache, job.chords.size(), job.tonality,
+                                                                     job.chords, job.qualities, job.states, false,
+                                                                     job.timeLimit, &result.optimal, job.token);
+                if(sol != nullptr){
+                    result.voicing = intVarArgs_to_int_vector(sol->getFullVoicing());
+                    result.costs = intVarArgs_to_int_vector(sol->get_cost_vector());
+                }
+                delete sol;
+            }
+            else{
+                /// only the voicing and the costs of the last solution are kept, no space is copied
+                solve_diatony_problem_stream(job.chords.size(), job.tonality, job.chords, job.qualities, job.states,
+                                             [&result](FourVoiceTexture &sol, const vector<int> &costs){
+                                                 result.voicing = intVarArgs_to_int_vector(sol.getFullVoicing());
+                                                 result.costs = costs;
+                                                 return true;
+                                             }, false, job.timeLimit, &result.optimal, FourVoiceTextureOptions(),
+                                             job.token);
+            }
+            auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+            std::chrono::duration<double> duration = currTime - start;
+            result.time = duration.count();
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+/**
+ * Returns one of the cutoff policies used by the engines of the portfolio
+ * @param policy the index of the policy
+ * @param size the number of chords
+ * @return 0: linear then geometric (default), 1: luby, 2: slowly growing geometric
+ */
+static Search::Cutoff* portfolio_cutoff(int policy, int size){
+    switch(policy){
+        case 1:
+            return Search::Cutoff::luby(4 * size);
+        case 2:
+            return Search::Cutoff::geometric(4 * size, 1.5);
+        default:
+            return restart_cutoff(size);
+    }
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem by racing several differently configured restart based
+ * branch and bound engines in parallel threads. The engines vary the variable selection heuristic, the random seed of
+ * the value selection and the cutoff policy, and share the best cost vector found so far. The first engine uses the
+ * default configuration of solve_diatony_problem.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param nOfWorkers the number of engines, 0 to use one engine per hardware thread
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return A FourVoiceTexture* representing the best solution found by any engine. If no solution is found, returns
+ * nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_portfolio(int size, Tonality* tonality, vector<int> chords,
+                                                  vector<int> qualities, vector<int> states, int nOfWorkers,
+                                                  bool print, double timeLimit){
+    if(nOfWorkers <= 0)
+        nOfWorkers = max(1, (int) std::thread::hardware_concurrency());
+    int nOfPolicies = 3;
+
+    SharedLexBound bound;
+    SharedStop stop(timeLimit); // stop after the time limit or when an engine proves optimality
+
+    /// the problems are created before launching the threads, so that an invalid problem throws in the calling thread
+    vector<FourVoiceTexture*> problems;
+    for(int w = 0; w < nOfWorkers; w++){
+        FourVoiceTextureOptions options;
+        options.variableSelection = (RIGHT_TO_LEFT + w) % N_OF_VARIABLE_SELECTIONS;
+        options.seed = w + 1;
+        options.sharedBound = &bound;
+        problems.push_back(new FourVoiceTexture(size, tonality, chords, qualities, states, options));
+    }
+
+    vector<FourVoiceTexture*> bestSolutions(nOfWorkers, nullptr);
+    vector<Search::Statistics> statistics(nOfWorkers);
+    vector<bool> completed(nOfWorkers, false);
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+
+    vector<std::thread> workers;
+    for(int w = 0; w < nOfWorkers; w++){
+        workers.emplace_back([&, w](){
+            Search::Options opts;
+            opts.threads = 1;
+            opts.stop = &stop;
+            opts.cutoff = portfolio_cutoff(w % nOfPolicies, size);
+            opts.nogoods_limit = size * 4 * 4;
+
+            RBS<FourVoiceTexture, BAB> solver(problems[w], opts);
+            delete problems[w];
+
+            while(FourVoiceTexture* next_sol = solver.next()){
+                bound.update(intVarArgs_to_int_vector(next_sol->get_cost_vector()));
+                delete bestSolutions[w];
+                bestSolutions[w] = next_sol;
+            }
+            statistics[w] = solver.statistics();
+            /// the search is complete: no solution is better than the shared bound, the other engines can stop
+            if(!solver.stopped()){
+                completed[w] = true;
+                stop.request_stop();
+            }
+        });
+    }
+    for(auto &worker : workers)
+        worker.join();
+
+    /// keep the best solution over all engines
+    FourVoiceTexture* bestSol = nullptr;
+    vector<int> bestCosts;
+    for(int w = 0; w < nOfWorkers; w++){
+        if(bestSolutions[w] == nullptr)
+            continue;
+        vector<int> costs = intVarArgs_to_int_vector(bestSolutions[w]->get_cost_vector());
+        if(bestSol == nullptr || costs < bestCosts){
+            delete bestSol;
+            bestSol = bestSolutions[w];
+            bestCosts = costs;
+        }
+        else
+            delete bestSolutions[w];
+    }
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(print){
+        for(int w = 0; w < nOfWorkers; w++){
+            std::cout << "engine " << w << " (" << variable_selection_heuristics_names[(RIGHT_TO_LEFT + w) % N_OF_VARIABLE_SELECTIONS]
+                      << ", seed " << w + 1 << ", cutoff policy " << w % nOfPolicies << ")"
+                      << (completed[w] ? " completed the search" : " was stopped") << std::endl;
+            std::cout << statistics_to_string(statistics[w]) << std::endl;
+        }
+        if(bestSol == nullptr)
+            std::cout << "No solutions" << std::endl;
+        else{
+            bool optimal = std::find(completed.begin(), completed.end(), true) != completed.end();
+            std::cout << (optimal ? "Best solution found" :
+                          "Best solution not found within the time limit. Current best solution found: ") << std::endl;
+            std::cout << bestSol->to_string() << std::endl;
+        }
+        std::cout << "time taken: " << duration.count() << " seconds with " << nOfWorkers << " engines.\n" << std::endl;
+    }
+    return bestSol;
+}
+
+/**
+ * Splits the search tree of a problem into independent subproblems by enumerating the values of the notes in the order
+ * in which the default branching assigns them (from the soprano of the last chord to the bass of the first one). The
+ * values removed by propagation are not enumerated.
+ * @param root the problem to split. Its propagation is performed
+ * @param nOfSubproblems the minimum number of subproblems wanted
+ * @return a list of subproblems, each one given as a list of (note index, value) assignments. The list is empty if the
+ * problem has no solution
+ */
+static vector<vector<pair<int,int>>> split_search_tree(FourVoiceTexture* root, int nOfSubproblems){
+    vector<vector<pair<int,int>>> subproblems;
+    if(root->status() == SS_FAILED)
+        return subproblems;
+    subproblems.emplace_back();
+    for(int var = 4 * root->get_size() - 1; var >= 0 && (int) subproblems.size() < nOfSubproblems; var--){
+        vector<vector<pair<int,int>>> next;
+        for(auto &assignments : subproblems){
+            auto sub = (FourVoiceTexture*) root->clone();
+            for(auto &a : assignments)
+                sub->fix_note(a.first, a.second);
+            if(sub->status() != SS_FAILED){
+                for(IntVarValues v(sub->getFullVoicing()[var]); v(); ++v){
+                    next.push_back(assignments);
+                    next.back().emplace_back(var, v.val());
+                }
+            }
+            delete sub;
+        }
+        subproblems = next;
+    }
+    return subproblems;
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem using several threads. Two modes are available:
+ * - the default mode uses the parallel restart based branch and bound of Gecode. The threads share the best solution,
+ *   but the order in which they find solutions depends on the scheduling, so two runs can return different optimal
+ *   solutions with different statistics.
+ * - the deterministic mode splits the search tree into independent subproblems that are solved in parallel by
+ *   sequential engines. The results are combined by cost vector, then by subproblem index, so two runs with the same
+ *   number of threads return the same solution and the same statistics as long as the search completes within the
+ *   time limit. The number of subproblems is derived from the number of threads (4 per thread), so runs with a
+ *   different number of threads split the tree differently: they find the same optimal cost, but possibly another
+ *   solution of that cost, with other statistics.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param nOfThreads the number of threads, 0 to use one thread per hardware thread
+ * @param deterministic true to use the deterministic mode
+ * @param print
+ * @param statistics if not nullptr, filled with the statistics of the search (summed over all subproblems in the
+ * deterministic mode)
+ * @param optimal if not nullptr, set to true if the search was complete, so that the solution is proven optimal
+ * @param hint a voicing to try first (warm start), or empty
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_parallel(int size, Tonality* tonality, vector<int> chords,
+                                                 vector<int> qualities, vector<int> states, int nOfThreads,
+                                                 bool deterministic, bool print, Search::Statistics* statistics,
+                                                 bool* optimal, const vector<int> &hint, double timeLimit){
+    if(nOfThreads <= 0)
+        nOfThreads = max(1, (int) std::thread::hardware_concurrency());
+
+    FourVoiceTexture* bestSol = nullptr;
+    Search::Statistics stats;
+    bool complete = true;
+    int nOfSubproblems = 1;
+    FourVoiceTextureOptions options;
+    options.hint = hint;
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+
+    if(!deterministic){
+        auto pb = new FourVoiceTexture(size, tonality, chords, qualities, states, options);
+        /// Search options
+        Search::TimeStop stop(timeLimit);
+        Search::Options opts;
+        opts.threads = nOfThreads;
+        opts.stop = &stop;
+        opts.cutoff = restart_cutoff(size);
+        opts.nogoods_limit = size * 4 * 4;
+
+        RBS<FourVoiceTexture, BAB> solver(pb, opts);
+        delete pb;
+
+        while(FourVoiceTexture* next_sol = solver.next()){
+            delete bestSol;
+            bestSol = next_sol;
+        }
+        stats = solver.statistics();
+        complete = !solver.stopped();
+    }
+    else{
+        /// several subproblems per thread so that the load is balanced
+        auto root = new FourVoiceTexture(size, tonality, chords, qualities, states);
+        vector<vector<pair<int,int>>> assignments = split_search_tree(root, 4 * nOfThreads);
+        delete root;
+        nOfSubproblems = assignments.size();
+
+        /// the subproblems are created before launching the threads, so that an invalid problem throws in the calling
+        /// thread. They are not cloned from the same space so that each one has its own random number generator
+        vector<FourVoiceTexture*> problems;
+        for(auto &subproblem : assignments){
+            auto pb = new FourVoiceTexture(size, tonality, chords, qualities, states, options);
+            for(auto &a : subproblem)
+                pb->fix_note(a.first, a.second);
+            problems.push_back(pb);
+        }
+
+        SharedStop stop(timeLimit);
+        vector<FourVoiceTexture*> bestSolutions(nOfSubproblems, nullptr);
+        vector<Search::Statistics> subStatistics(nOfSubproblems);
+        vector<char> stopped(nOfSubproblems, false);
+        std::atomic<int> nextSubproblem(0);
+
+        vector<std::thread> workers;
+        for(int w = 0; w < min(nOfThreads, nOfSubproblems); w++){
+            workers.emplace_back([&](){
+                for(int i = nextSubproblem++; i < nOfSubproblems; i = nextSubproblem++){
+                    Search::Options opts;
+                    opts.threads = 1;
+                    opts.stop = &stop;
+                    opts.cutoff = restart_cutoff(size);
+                    opts.nogoods_limit = size * 4 * 4;
+
+                    RBS<FourVoiceTexture, BAB> solver(problems[i], opts);
+                    delete problems[i];
+
+                    while(FourVoiceTexture* next_sol = solver.next()){
+                        delete bestSolutions[i];
+                        bestSolutions[i] = next_sol;
+                    }
+                    subStatistics[i] = solver.statistics();
+                    stopped[i] = solver.stopped();
+                }
+            });
+        }
+        for(auto &worker : workers)
+            worker.join();
+
+        /// combine the results in the order of the subproblems, ties are broken by the smallest index
+        vector<int> bestCosts;
+        for(int i = 0; i < nOfSubproblems; i++){
+            stats += subStatistics[i];
+            complete = complete && !stopped[i];
+            if(bestSolutions[i] == nullptr)
+                continue;
+            vector<int> costs = intVarArgs_to_int_vector(bestSolutions[i]->get_cost_vector());
+            if(bestSol == nullptr || costs < bestCosts){
+                delete bestSol;
+                bestSol = bestSolutions[i];
+                bestCosts = costs;
+            }
+            else
+                delete bestSolutions[i];
+        }
+    }
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(statistics != nullptr)
+        *statistics = stats;
+    if(optimal != nullptr)
+        *optimal = complete && bestSol != nullptr;
+    if(print){
+        if(bestSol == nullptr)
+            std::cout << "No solutions" << std::endl;
+        else{
+            std::cout << (complete ? "Best solution found" :
+                          "Best solution not found within the time limit. Current best solution found: ") << std::endl;
+            std::cout << bestSol->to_string() << std::endl;
+        }
+        std::cout << statistics_to_string(stats) << std::endl;
+        std::cout << "time taken: " << duration.count() << " seconds with " << nOfThreads << " threads";
+        if(deterministic)
+            std::cout << " and " << nOfSubproblems << " subproblems";
+        std::cout << ".\n" << std::endl;
+    }
+    return bestSol;
+}
+
+/**
+ * Finds a near optimal solution for a four voice texture problem by large neighbourhood search. Once a first solution
+ * is found, each restart keeps all the chords of the best solution except a window of consecutive chords, which is
+ * re-optimized. The window is chosen at random or around the chords that cost the most in the best solution. The
+ * search never proves optimality and runs until the time limit, which makes it suited to long progressions.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param window the number of chords re-optimized at each restart, 0 to choose it depending on the size
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param print
+ * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_lns(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                            vector<int> states, int window, double timeLimit, bool print){
+    if(window <= 0)
+        window = max(4, size / 8);
+    FourVoiceTextureOptions options;
+    options.lnsWindow = window;
+    auto pb = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities), std::move(states), options);
+    /// Search options
+    Search::TimeStop stop(timeLimit);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    /// the neighbourhoods are small: most restarts are short, but some are long enough to find the first solution
+    opts.cutoff = Search::Cutoff::luby(4 * 4 * window);
+    opts.nogoods_limit = 0; // no-goods found in a neighbourhood are not valid for the whole problem
+
+    RBS<FourVoiceTexture, BAB> solver(pb, opts);
+    delete pb;
+
+    FourVoiceTexture* bestSol = nullptr;
+    int n_sols = 0;
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    while(FourVoiceTexture* next_sol = solver.next()){
+        n_sols++;
+        delete bestSol;
+        bestSol = next_sol;
+        if(print){
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            std::cout << "solution " << n_sols << " found after " << duration.count() << " seconds with cost vector "
+                      << intVarArgs_to_string(bestSol->get_cost_vector()) << std::endl;
+        }
+    }
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(print){
+        if(bestSol == nullptr)
+            std::cout << "No solutions" << std::endl;
+        else{
+            std::cout << "Best solution found by large neighbourhood search (windows of " << window << " chords)"
+                      << std::endl;
+            std::cout << bestSol->to_string() << std::endl;
+        }
+        std::cout << statistics_to_string(solver.statistics()) << std::endl;
+        std::cout << "time taken: " << duration.count() << " seconds and " << n_sols << " solutions found.\n" << std::endl;
+    }
+    return bestSol;
+}
+
+/**
+ * Returns whether a cadence ends on a chord, that is, the chord is a fundamental state tonic or submediant chord
+ * preceded by a fundamental state dominant chord, or a fundamental state tonic chord preceded by a fundamental state
+ * subdominant chord
+ * @param chords the chord degrees of the progression
+ * @param states the states of the chords
+ * @param pos the position of the chord in the progression
+ * @return true if a cadence ends on the chord at position pos
+ */
+static bool is_cadence(const vector<int> &chords, const vector<int> &states, int pos){
+    if(pos == 0 || states[pos - 1] != FUNDAMENTAL_STATE || states[pos] != FUNDAMENTAL_STATE)
+        return false;
+    if(chords[pos - 1] == FIFTH_DEGREE)
+        return chords[pos] == FIRST_DEGREE || chords[pos] == SIXTH_DEGREE;
+    return chords[pos - 1] == FOURTH_DEGREE && chords[pos] == FIRST_DEGREE;
+}
+
+/**
+ * Finds the best voicing of the chords from..to of a progression. The problem solved also contains the chord before
+ * and the chord after the window if there are some, so that the chords of the window follow the rules between chords
+ * of the whole progression and not the rules of the first and last chords of a progression. The chords of that
+ * problem marked as fixed keep their voicing, the others are free.
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param from the position of the first chord of the window
+ * @param to the position of the last chord of the window
+ * @param voicing the notes of the whole progression, only read for the fixed chords
+ * @param fixed for each chord of the progression, true if its voicing must be kept
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return the notes of the chords of the window, or an empty vector if no solution was found
+ */
+static vector<int> solve_window(Tonality* tonality, const vector<int> &chords, const vector<int> &qualities,
+                                const vector<int> &states, int from, int to, const vector<int> &voicing,
+                                const vector<char> &fixed, double timeLimit){
+    /// the chords of the problem, with one chord of context on each side of the window
+    int lo = max(0, from - 1);
+    int hi = min((int) chords.size() - 1, to + 1);
+    int windowSize = hi - lo + 1;
+    FourVoiceTexture* pb = new FourVoiceTexture(windowSize, tonality,
+                                                vector<int>(chords.begin() + lo, chords.begin() + hi + 1),
+                                                vector<int>(qualities.begin() + lo, qualities.begin() + hi + 1),
+                                                vector<int>(states.begin() + lo, states.begin() + hi + 1));
+    for(int c = lo; c <= hi; c++)
+        if(fixed[c])
+            for(int v = 0; v < 4; v++)
+                pb->fix_note(4 * (c - lo) + v, voicing[4 * c + v]);
+
+    Search::TimeStop stop(timeLimit);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    opts.cutoff = restart_cutoff(windowSize);
+    opts.nogoods_limit = windowSize * 4 * 4;
+
+    RBS<FourVoiceTexture, BAB> solver(pb, opts);
+    delete pb;
+
+    vector<int> windowVoicing;
+    while(FourVoiceTexture* next_sol = solver.next()){
+        vector<int> problemVoicing = intVarArgs_to_int_vector(next_sol->getFullVoicing());
+        windowVoicing.assign(problemVoicing.begin() + 4 * (from - lo), problemVoicing.begin() + 4 * (to - lo + 1));
+        delete next_sol;
+    }
+    return windowVoicing;
+}
+
+/**
+ * Harmonizes a segment of a progression with overlapping windows. The first chord of each window is fixed to the last
+ * chord of the previous one, and the chord before it is fixed as context. When a window has no solution, it is
+ * extended backward over the previous window, up to the start of the segment. Only the chords of the segment are read
+ * from the voicing, so that segments can be solved in parallel.
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param from the position of the first chord of the segment
+ * @param to the position of the last chord of the segment
+ * @param fixedStart true if the first chord of the segment and the chord before it are already in voicing and must be
+ * kept
+ * @param window the number of chords in each window
+ * @param windowTimeLimit the time limit of the search of each window in milliseconds
+ * @param voicing the notes of the whole progression, filled with the notes of the segment
+ * @return true if a solution was found for the segment
+ */
+static bool solve_segment(Tonality* tonality, const vector<int> &chords, const vector<int> &qualities,
+                          const vector<int> &states, int from, int to, bool fixedStart, int window,
+                          double windowTimeLimit, vector<int> &voicing){
+    /// the chords whose voicing is known, the others are never read
+    vector<char> known(chords.size(), false);
+    if(fixedStart)
+        for(int c = max(0, from - 1); c <= from; c++)
+            known[c] = true;
+    int start = from;       /// the first chord of the current window
+    while(true){
+        int end = min(to, start + window - 1);
+        int windowStart = start;
+        vector<int> windowVoicing;
+        /// extend the window backward until it has a solution
+        while(true){
+            /// the first chord of the window keeps the voicing it has in the previous window, the others are free
+            vector<char> fixed = known;
+            for(int c = windowStart + 1; c <= end; c++)
+                fixed[c] = false;
+            windowVoicing = solve_window(tonality, chords, qualities, states, windowStart, end, voicing, fixed,
+                                         windowTimeLimit);
+            if(!windowVoicing.empty() || windowStart == from)
+                break;
+            windowStart = max(from, windowStart - (window - 1));
+        }
+        if(windowVoicing.empty())
+            return false;
+        std::copy(windowVoicing.begin(), windowVoicing.end(), voicing.begin() + 4 * windowStart);
+        for(int c = windowStart; c <= end; c++)
+            known[c] = true;
+        if(end == to)
+            return true;
+        start = end;
+    }
+}
+
+/**
+ * Finds a near optimal solution for a long progression by solving it as a sequence of small problems. The progression
+ * is cut after the cadences (perfect, plagal and interrupted) into segments that are harmonized in parallel. Each
+ * segment is solved with windows of consecutive chords that overlap by one chord: the first chord of a window is fixed
+ * to the last chord of the previous window. Each window is solved with the chords next to it as context, so that its
+ * chords follow the rules of the inner chords of a progression. If a window has no solution with that boundary, it is
+ * extended backward over the previous window. The chords on both sides of a cut are then re-optimized with their
+ * neighbours fixed. The result is checked and evaluated by the model of the whole progression, and repaired by a
+ * search of the whole progression starting from it if it breaks a rule.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param window the number of chords in each window (at least 2)
+ * @param windowTimeLimit the time limit of the search of each window in milliseconds
+ * @param nOfThreads the number of threads used for the segments, 0 to use one thread per hardware thread
+ * @param compare true to also solve the whole progression at once and report the gap between the cost vectors
+ * @param print
+ * @return A FourVoiceTexture* representing the solution. If no solution is found, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_windows(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                                vector<int> states, int window, double windowTimeLimit,
+                                                int nOfThreads, bool compare, bool print){
+    window = max(2, window);
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+
+    /// cut the progression after the cadences, keeping segments of at least one window
+    vector<pair<int,int>> segments;
+    int segmentStart = 0;
+    for(int i = 1; i < size - 1; i++){
+        if(is_cadence(chords, states, i) && i - segmentStart + 1 >= window && size - i - 1 >= window){
+            segments.emplace_back(segmentStart, i);
+            segmentStart = i + 1;
+        }
+    }
+    segments.emplace_back(segmentStart, size - 1);
+
+    /// harmonize the segments in parallel
+    vector<int> voicing(4 * size, 0);
+    vector<char> solved(segments.size(), false);
+    {
+        WorkStealingPool pool(min(nOfThreads <= 0 ? (int) std::thread::hardware_concurrency() : nOfThreads,
+                                  (int) segments.size()));
+        for(int s = 0; s < segments.size(); s++){
+            pool.submit([&, s](){
+                /// segments write disjoint parts of the voicing
+                solved[s] = solve_segment(tonality, chords, qualities, states, segments[s].first, segments[s].second,
+                                          false, window, windowTimeLimit, voicing);
+            });
+        }
+        pool.wait();
+    }
+
+    bool found = std::find(solved.begin(), solved.end(), false) == solved.end();
+    /// re-optimize the last chord of each segment and the first chord of the next one with their neighbours fixed. If
+    /// that fails, the next segment is solved again from the end of the previous one
+    for(int s = 0; found && s + 1 < segments.size(); s++){
+        int cut = segments[s].second;
+        vector<char> fixed(size, true);
+        fixed[cut] = fixed[cut + 1] = false;
+        vector<int> seam = solve_window(tonality, chords, qualities, states, cut, cut + 1, voicing, fixed,
+                                        windowTimeLimit);
+        if(!seam.empty())
+            std::copy(seam.begin(), seam.end(), voicing.begin() + 4 * cut);
+        else
+            found = solve_segment(tonality, chords, qualities, states, cut, segments[s + 1].second, true, window,
+                                  windowTimeLimit, voicing);
+    }
+
+    /// check and evaluate the voicing with the model of the whole progression. A window only sees one chord on each
+    /// side, so a rule spanning more chords can still be broken at the seams: the whole progression is then searched
+    /// with the voicing of the windows as a hint, which keeps most of it
+    FourVoiceTexture* sol = nullptr;
+    if(found){
+        sol = new FourVoiceTexture(size, tonality, chords, qualities, states);
+        sol->fix_voicing(voicing);
+        if(sol->status() == SS_FAILED){
+            delete sol;
+            if(print)
+                std::cout << "The voicing found by the windows violates the model of the whole progression, it is "
+                             "repaired by a search starting from it" << std::endl;
+            FourVoiceTextureOptions options;
+            options.hint = voicing;
+            bool repairComplete = false;
+            sol = solve_for_best(size, tonality, chords, qualities, states, false, windowTimeLimit, &repairComplete,
+                                 options);
+        }
+    }
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(print){
+        if(sol == nullptr)
+            std::cout << "No solutions" << std::endl;
+        else{
+            std::cout << "Solution found with " << segments.size() << " segments and windows of " << window
+                      << " chords" << std::endl;
+            std::cout << sol->to_string() << std::endl;
+        }
+        std::cout << "time taken: " << duration.count() << " seconds.\n" << std::endl;
+    }
+
+    if(compare && sol != nullptr){
+        bool complete = false;
+        auto monolithicStart = std::chrono::high_resolution_clock::now();
+        vector<int> optimalCosts;
+        int nOfSols = solve_diatony_problem_stream(size, tonality, chords, qualities, states,
+                                                   [&optimalCosts](FourVoiceTexture &s, const vector<int> &costs){
+                                                       optimalCosts = costs;
+                                                       return true;
+                                                   }, false, 60000, &complete);
+        std::chrono::duration<double> monolithicDuration = std::chrono::high_resolution_clock::now() - monolithicStart;
+        if(nOfSols > 0 && complete){
+            vector<int> windowCosts = intVarArgs_to_int_vector(sol->get_cost_vector());
+            vector<int> gap;
+            for(int i = 0; i < windowCosts.size(); i++)
+                gap.push_back(windowCosts[i] - optimalCosts[i]);
+            std::cout << "windows: {" << int_vector_to_string(windowCosts) << "} in " << duration.count()
+                      << " seconds, whole progression: {" << int_vector_to_string(optimalCosts) << "} in "
+                      << monolithicDuration.count() << " seconds, gap: {" << int_vector_to_string(gap) << "}"
+                      << std::endl;
+        }
+        else
+            std::cout << "The whole progression was not solved to optimality, no gap reported" << std::endl;
+    }
+    return sol;
+}
+
+/**
+ * Finds the best solution it can for a four voice texture problem within a wall-clock deadline. A first solution is
+ * searched by depth first search without optimization within a share of the deadline. The rest of the deadline is
+ * spent in branch and bound, starting from that first solution as a hint.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param deadline the wall-clock budget in milliseconds, model construction included
+ * @param optimal if not nullptr, set to true if the search was complete: the solution returned is optimal or, if
+ * nullptr is returned, the problem is proven to have no solution. nullptr with optimal false means that no solution was
+ * found before the deadline
+ * @param print
+ * @param firstSolutionShare the share of the deadline given to the search for a first solution, in ]0,1]
+ * @return A FourVoiceTexture* representing the best solution found within the deadline. If no solution is found,
+ * returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_deadline(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                                 vector<int> states, double deadline, bool* optimal, bool print,
+                                                 double firstSolutionShare){
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    auto elapsed = [&start](){
+        std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+        return duration.count();
+    };
+    if(optimal != nullptr)
+        *optimal = false;
+
+    /// first phase: any solution, as fast as possible
+    FourVoiceTexture* first;
+    {
+        FourVoiceTexture* pb = new FourVoiceTexture(size, tonality, chords, qualities, states);
+        Search::TimeStop stop(max(1.0, deadline * firstSolutionShare - elapsed()));
+        Search::Options opts;
+        opts.threads = 1;
+        opts.stop = &stop;
+        DFS<FourVoiceTexture> solver(pb, opts);
+        delete pb;
+        first = solver.next();
+        if(first == nullptr && !solver.stopped()){  /// the problem has no solution: nullptr is the optimal answer
+            if(optimal != nullptr)
+                *optimal = true;
+            if(print)
+                std::cout << "No solutions" << std::endl;
+            return nullptr;
+        }
+    }
+    if(print && first != nullptr){
+        std::cout << "First solution found after " << elapsed() << " ms" << std::endl;
+        std::cout << first->to_string() << std::endl;
+    }
+
+    /// second phase: improve on the first solution until the deadline. The model is built before the remaining time is
+    /// computed so that its construction counts in the deadline, and only solutions better than the first one are kept
+    FourVoiceTextureOptions options;
+    if(first != nullptr)
+        options.hint = intVarArgs_to_int_vector(first->getFullVoicing());
+    FourVoiceTexture* pb = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities),
+                                                std::move(states), options);
+    if(first != nullptr)
+        pb->constrain(*first);
+    double remaining = deadline - elapsed();
+    if(remaining <= 0){
+        delete pb;
+        return first;
+    }
+    Search::TimeStop stop(remaining);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    opts.cutoff = restart_cutoff(size);
+    opts.nogoods_limit = size * 4 * 4;
+    RBS<FourVoiceTexture, BAB> solver(pb, opts);
+    delete pb;
+
+    FourVoiceTexture* best = nullptr;
+    while(FourVoiceTexture* next_sol = solver.next()){
+        delete best;
+        best = next_sol;
+    }
+    bool complete = !solver.stopped();
+    /// a complete search without a better solution proves the first one optimal, or the problem infeasible
+    if(optimal != nullptr)
+        *optimal = complete;
+    if(best == nullptr)
+        return first;
+    delete first;
+    if(print){
+        std::cout << (complete ? "Best solution found" : "Best solution found before the deadline") << " after "
+                  << elapsed() << " ms" << std::endl;
+        std::cout << best->to_string() << std::endl;
+    }
+    return best;
+}
+
+/**
+ * Finds an optimal solution for a four voice texture problem by dynamic programming over the legal voicings of each
+ * chord. The solution is then assigned in a FourVoiceTexture instance so that it is checked by the constraint model.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param print
+ * @return A FourVoiceTexture* representing the optimal solution. If no solution exists, returns nullptr.
+ */
+FourVoiceTexture* solve_diatony_problem_dp(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
+                                           vector<int> states, bool print){
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    VoicingRules rules(size, tonality, chords, qualities, states);
+    vector<int> costs;
+    vector<int> voicing = rules.optimal_voicing(costs);
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(voicing.empty()){
+        if(print)
+            std::cout << "No solutions" << std::endl;
+        return nullptr;
+    }
+
+    /// assign the solution in the constraint model to compute all the variables and check it
+    auto sol = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities), std::move(states));
+    sol->fix_voicing(voicing);
+    if(sol->status() == SS_FAILED){
+        std::cerr << "The voicing found by dynamic programming violates the constraint model: "
+                  << int_vector_to_string(voicing) << std::endl;
+        delete sol;
+        return nullptr;
+    }
+    if(print){
+        std::cout << "Best solution found" << std::endl;
+        std::cout << sol->to_string() << std::endl;
+        std::cout << "Cost vector computed by dynamic programming = {" << int_vector_to_string(costs) << "}" << std::endl;
+        std::cout << "time taken: " << duration.count() << " seconds.\n" << std::endl;
+    }
+    return sol;
+}
+
+/**
+ * Looks up the optimal solution of a four voice texture problem in a solution store, without building its model. Only
+ * a solution proven optimal with the current version of the model is returned, so it can be used without search.
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param store the store of the solutions of the problems solved so far
+ * @param solution filled with the voicing and the cost vector of the stored solution
+ * @return true if the store has a solution of the problem proven optimal with the current version of the model
+ */
+bool find_stored_optimal_solution(Tonality* tonality, const vector<int> &chords, const vector<int> &qualities,
+                                  const vector<int> &states, const SolutionStore &store, StoredSolution &solution){
+    StoredProblem problem = {tonality->get_tonic(), tonality->get_mode(), chords, qualities, states};
+    return store.get(problem, solution) && solution.optimal && solution.modelVersion == MODEL_VERSION;
+}
+
 /**
  * Finds an optimal solution for a four voice texture problem.
  * @param size the number of chords
@@ -83,15 +1107,72 @@ solve_diatony_problem(int size, Tonality *tonality, vector<int> chords, vector<i
  * @param qualities the qualities of the chords
  * @param states the states of the chords
  * @param print
+ * @param engine the engine used to solve the problem (see solving_engines)
+ * @param store if not nullptr, the store of the solutions of the problems solved so far. A solution found in the store
+ * that was proven optimal with the current version of the model is returned without search, any other is the hint of
+ * the search (for all the engines but dynamic programming, which needs none). The solution found is written to the
+ * store, proven optimal if the search was complete.
  * @return A FourVoiceTexture* representing the best solution found. If no solution is found, returns nullptr.
  * If the best solution is not found during search, returns the last solution found (best so far).
  */
 FourVoiceTexture* solve_diatony_problem_optimal(int size, Tonality* tonality, vector<int> chords, vector<int> qualities,
-                                                vector<int> states, bool print){
-    auto sols = solve_diatony_problem(size, tonality, std::move(chords), std::move(qualities), std::move(states), print);
-    if(sols.empty())
-        return nullptr;
-    return sols.back();
+                                                vector<int> states, bool print, int engine, SolutionStore* store){
+    StoredProblem problem = {tonality->get_tonic(), tonality->get_mode(), chords, qualities, states};
+    FourVoiceTextureOptions options;
+    if(store != nullptr){
+        StoredSolution stored;
+        if(store->get(problem, stored)){
+            /// a solution found with another version of the model is only a hint: it may not respect the current rules.
+            /// The model is only built to return the stored solution as a space, callers that only need its voicing and
+            /// costs use find_stored_optimal_solution
+            if(stored.optimal && stored.modelVersion == MODEL_VERSION){
+                auto sol = new FourVoiceTexture(size, tonality, chords, qualities, states);
+                sol->fix_voicing(stored.voicing);
+                if(sol->status() != SS_FAILED){
+                    if(print){
+                        std::cout << "Best solution found in the solution store" << std::endl;
+                        std::cout << sol->to_string() << std::endl;
+                    }
+                    return sol;
+                }
+                /// the rules have changed since the solution was stored
+                delete sol;
+            }
+            options.hint = stored.voicing;
+        }
+    }
+
+    FourVoiceTexture* sol = nullptr;
+    bool optimal = false;
+    if(engine == DYNAMIC_PROGRAMMING_ENGINE){
+        sol = solve_diatony_problem_dp(size, tonality, chords, qualities, states, print);
+        optimal = true;
+    }
+    else if(engine == LNS_ENGINE){
+        /// large neighbourhood search never proves optimality: it only gets a short budget to find a good solution,
+        /// which is then the hint of a complete search that can prove it optimal in the rest of the time
+        FourVoiceTexture* lnsSol = solve_diatony_problem_lns(size, tonality, chords, qualities, states, 0,
+                                                             LNS_PHASE_TIME_LIMIT, print);
+        if(lnsSol != nullptr)
+            options.hint = intVarArgs_to_int_vector(lnsSol->getFullVoicing());
+        sol = solve_for_best(size, tonality, chords, qualities, states, print, 60000 - LNS_PHASE_TIME_LIMIT, &optimal,
+                             options);
+        if(sol == nullptr)
+            sol = lnsSol;
+        else
+            delete lnsSol;
+    }
+    else if(engine == PARALLEL_ENGINE || engine == DETERMINISTIC_PARALLEL_ENGINE)
+        sol = solve_diatony_problem_parallel(size, tonality, chords, qualities, states, 0,
+                                             engine == DETERMINISTIC_PARALLEL_ENGINE, print, nullptr, &optimal,
+                                             options.hint);
+    else
+        sol = solve_for_best(size, tonality, chords, qualities, states, print, 60000, &optimal, options);
+
+    if(store != nullptr && sol != nullptr)
+        store->add(problem, {intVarArgs_to_int_vector(sol->getFullVoicing()),
+                             intVarArgs_to_int_vector(sol->get_cost_vector()), optimal, MODEL_VERSION});
+    return sol;
 }
 
 /**
@@ -128,4 +1209,79 @@ vector<FourVoiceTexture*> find_optimal_solutions_with_margin(int size, Tonality*
     }
     std::cout << n_sols << " solutions found with a margin on costs of " << to_string(margin) << std::endl;
     return solutions;
-}
\ No newline at end of file
+}
+
+/**
+ * Finds the best distinct solutions of a four voice texture problem within a margin of the optimal solution in a
+ * single branch and bound search. Instead of requiring each new solution to improve on the last one, the search keeps
+ * an archive of the best solutions found so far and only requires new solutions to improve on the worst archived one
+ * once the archive is full.
+ * @param size the number of chords
+ * @param tonality the tonality of the piece
+ * @param chords the chord degrees of the progression
+ * @param qualities the qualities of the chords
+ * @param states the states of the chords
+ * @param margin a percentage of "error" that is allowed to find close to optimal solutions (see SolutionArchive)
+ * @param nOfSolutions the maximum number of solutions kept
+ * @param print
+ * @param timeLimit the time limit of the search in milliseconds
+ * @param complete if not nullptr, set to true if the search was not stopped by the time limit
+ * @return the best solutions within the margin of the best one, best first. If the search is complete, the first one
+ * is optimal and the others are the best solutions within the margin, up to nOfSolutions.
+ */
+vector<FourVoiceTexture*> solve_diatony_problem_near_optimal(int size, Tonality* tonality, vector<int> chords,
+                                                             vector<int> qualities, vector<int> states, double margin,
+                                                             int nOfSolutions, bool print, double timeLimit,
+                                                             bool* complete){
+    SolutionArchive archive(nOfSolutions, margin);
+    FourVoiceTextureOptions options;
+    options.archive = &archive;
+    FourVoiceTexture* pb = new FourVoiceTexture(size, tonality, std::move(chords), std::move(qualities),
+                                                std::move(states), options);
+    CancellableStop stop(timeLimit, nullptr);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    /// no restarts: a solution that does not improve the archive could be found again after a restart
+    BAB<FourVoiceTexture> solver(pb, opts);
+    delete pb;
+
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    map<vector<int>, FourVoiceTexture*> archived;               /// the spaces of the archived solutions
+    int n_sols = 0;
+    while(FourVoiceTexture* next_sol = solver.next()){
+        n_sols++;
+        vector<int> voicing = intVarArgs_to_int_vector(next_sol->getFullVoicing());
+        vector<vector<int>> removed;
+        if(!archive.add(intVarArgs_to_int_vector(next_sol->get_cost_vector()), voicing, &removed)){
+            delete next_sol;
+            continue;
+        }
+        archived[voicing] = next_sol;
+        for(const auto &r : removed){
+            delete archived[r];
+            archived.erase(r);
+        }
+    }
+    if(complete != nullptr)
+        *complete = !solver.stopped();
+
+    vector<FourVoiceTexture*> solutions;
+    for(const auto &solution : archive.get_solutions())
+        solutions.push_back(archived[solution.second]);
+
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    if(print){
+        for(int i = 0; i < solutions.size(); i++){
+            std::cout << "Solution (" << i + 1 << ")" << std::endl;
+            std::cout << solutions[i]->to_string() << std::endl;
+        }
+        std::cout << solutions.size() << " solutions found with a margin on costs of " << to_string(margin) << " among "
+                  << n_sols << " solutions found during search" << (solver.stopped() ? " (time limit reached)" : "")
+                  << std::endl;
+        std::cout << statistics_to_string(solver.statistics()) << std::endl;
+        std::cout << "time taken: " << duration.count() << " seconds.\n" << std::endl;
+    }
+    return solutions;
+}
@@ -0,0 +1,74 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A process-wide cache of the tables of legal transitions between two chords, so that they are
+//                enumerated only once for each pair of chord signatures.
+//
+#include "../../headers/diatony/TransitionTableCache.hpp"
+
+/**
+ * Compares two transition signatures in lexicographical order of their fields
+ * @param other another transition signature
+ * @return true if this signature comes before the other one
+ */
+bool TransitionSignature::operator<(const TransitionSignature &other) const {
+    if(current < other.current || other.current < current)
+        return current < other.current;
+    if(next < other.next || other.next < next)
+        return next < other.next;
+    return context < other.context;
+}
+
+std::mutex TransitionTableCache::lock;
+map<TransitionSignature, TransitionTable> TransitionTableCache::tables;
+
+/**
+ * Returns the table of the legal transitions of a pair of chords, enumerating them the first time the pair is met
+ * @param signature the signature of the pair of chords
+ * @param enumerate a function enumerating the legal transitions of the pair of chords
+ * @return the legal transitions of the pair of chords
+ */
+const TransitionTable& TransitionTableCache::get(const TransitionSignature &signature,
+                                                 const function<TransitionTable()> &enumerate) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = tables.find(signature);
+        if(it != tables.end())
+            return it->second;
+    }
+    /// the enumeration is done without holding the lock. If two threads enumerate the same signature, the first one
+    /// to finish is kept
+    auto start = std::chrono::high_resolution_clock::now();
+    TransitionTable enumerated = enumerate();
+    enumerated.enumerationTime =
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::lock_guard<std::mutex> guard(lock);
+    return tables.insert(std::make_pair(signature, enumerated)).first->second;
+}
+
+/**
+ * Returns the number of pairs of chords in the cache
+ * @return the number of signatures whose transitions have been enumerated
+ */
+int TransitionTableCache::get_size() {
+    std::lock_guard<std::mutex> guard(lock);
+    return tables.size();
+}
+
+/**
+ * Returns the size of the tables in the cache and the time spent enumerating them
+ * @return the statistics of the cache since the start of the process
+ */
+TransitionTableStatistics TransitionTableCache::get_statistics() {
+    std::lock_guard<std::mutex> guard(lock);
+    TransitionTableStatistics statistics;
+    for(const auto &entry : tables){
+        if(entry.second.tooLarge)
+            statistics.nOfTooLarge++;
+        else{
+            statistics.nOfTables++;
+            statistics.nOfTuples += entry.second.tuples.tuples();
+        }
+        statistics.enumerationTime += entry.second.enumerationTime;
+    }
+    return statistics;
+}
@@ -14,54 +14,56 @@
  *      in fundamental state                                                                                           *
  *      - interrupted_cadence: sets the constraint for a fifth degree followed by a sixth degree in                    *
  *      fundamental state                                                                                              *
+ *      - legal_transitions: restrains two consecutive chords to a table of legal transitions                          *
+ *      (replaces the other constraints between the two chords)                                                        *
  *                                                                                                                     *
  ***********************************************************************************************************************/
 
 /**
- * Forbids a list of parallel intervals between two voices. This calls the forbid_parallel_interval function
+ * Forbids a list of parallel intervals between two voices when moving from the chord at currentPosition to the next
+ * one. This calls the forbid_parallel_interval function
  * @param home the instance of the problem
- * @param size the size of the chord progression
+ * @param currentPosition the current position in the chord progression
  * @param nOfVoices the number of voices
  * @param intervals the list of intervals to forbid
  * @param FullChordsVoicing the array containing all the notes of the chords in the progression
- * @param bassTenorHarmonicIntervals the array containing the harmonic intervals between bass and tenor
- * @param bassAltoHarmonicIntervals the array containing the harmonic intervals between bass and alto
- * @param bassSopranoHarmonicIntervals the array containing the harmonic intervals between bass and soprano
- * @param tenorAltoHarmonicIntervals the array containing the harmonic intervals between tenor and alto
- * @param tenorSopranoHarmonicIntervals the array containing the harmonic intervals between tenor and soprano
- * @param altoSopranoHarmonicIntervals the array containing the harmonic intervals between alto and soprano
+ * @param bassTenorIntervalClasses the array containing the classes of the harmonic intervals between bass and tenor
+ * @param bassAltoIntervalClasses the array containing the classes of the harmonic intervals between bass and alto
+ * @param bassSopranoIntervalClasses the array containing the classes of the harmonic intervals between bass and soprano
+ * @param tenorAltoIntervalClasses the array containing the classes of the harmonic intervals between tenor and alto
+ * @param tenorSopranoIntervalClasses the array containing the classes of the harmonic intervals between tenor and soprano
+ * @param altoSopranoIntervalClasses the array containing the classes of the harmonic intervals between alto and soprano
  */
-void forbid_parallel_intervals(const Home &home, int size, int nOfVoices, const vector<int> &intervals,
-                               const IntVarArray &FullChordsVoicing, const IntVarArray &bassTenorHarmonicIntervals,
-                               const IntVarArray &bassAltoHarmonicIntervals,
-                               const IntVarArray &bassSopranoHarmonicIntervals,
-                               const IntVarArray &tenorAltoHarmonicIntervals,
-                               const IntVarArray &tenorSopranoHarmonicIntervals,
-                               const IntVarArray &altoSopranoHarmonicIntervals) {
-    for(int chord = 0; chord < size - 1; chord++){ /// for each chord
-        for(int interval : intervals){ /// for each interval
-            /// from bass
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     BASS, TENOR, bassTenorHarmonicIntervals,
-                                     FullChordsVoicing); // between bass and tenor
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     BASS, ALTO, bassAltoHarmonicIntervals,
-                                     FullChordsVoicing); // between tenor and alto
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     BASS,SOPRANO, bassSopranoHarmonicIntervals,
-                                     FullChordsVoicing); // between alto and soprano
-            /// from tenor
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     TENOR,ALTO, tenorAltoHarmonicIntervals,
-                                     FullChordsVoicing); // between tenor and alto
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     TENOR,SOPRANO, tenorSopranoHarmonicIntervals,
-                                     FullChordsVoicing); // between tenor and soprano
-            /// from alto
-            forbid_parallel_interval(home, nOfVoices, interval, chord,
-                                     ALTO,SOPRANO, altoSopranoHarmonicIntervals,
-                                     FullChordsVoicing); // between alto and soprano
-        }
+void forbid_parallel_intervals(const Home &home, int currentPosition, int nOfVoices, const vector<int> &intervals,
+                               const IntVarArray &FullChordsVoicing, const IntVarArray &bassTenorIntervalClasses,
+                               const IntVarArray &bassAltoIntervalClasses,
+                               const IntVarArray &bassSopranoIntervalClasses,
+                               const IntVarArray &tenorAltoIntervalClasses,
+                               const IntVarArray &tenorSopranoIntervalClasses,
+                               const IntVarArray &altoSopranoIntervalClasses) {
+    int chord = currentPosition;
+    for(int interval : intervals){ /// for each interval
+        /// from bass
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 BASS, TENOR, bassTenorIntervalClasses,
+                                 FullChordsVoicing); // between bass and tenor
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 BASS, ALTO, bassAltoIntervalClasses,
+                                 FullChordsVoicing); // between tenor and alto
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 BASS,SOPRANO, bassSopranoIntervalClasses,
+                                 FullChordsVoicing); // between alto and soprano
+        /// from tenor
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 TENOR,ALTO, tenorAltoIntervalClasses,
+                                 FullChordsVoicing); // between tenor and alto
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 TENOR,SOPRANO, tenorSopranoIntervalClasses,
+                                 FullChordsVoicing); // between tenor and soprano
+        /// from alto
+        forbid_parallel_interval(home, nOfVoices, interval, chord,
+                                 ALTO,SOPRANO, altoSopranoIntervalClasses,
+                                 FullChordsVoicing); // between alto and soprano
     }
 }
 
@@ -74,16 +76,16 @@ void forbid_parallel_intervals(const Home &home, int size, int nOfVoices, const
  * @param currentPosition the current position in the chord progression
  * @param voice1ID the ID of the first voice
  * @param voice2ID the ID of the second voice
- * @param voicesHarmonicIntervals the array containing the harmonic intervals between adjacent voices
+ * @param voicesIntervalClasses the array containing the classes of the harmonic intervals between the two voices
  * @param FullChordsVoicing the array containing all the notes of the chords in the progression
  */
 void forbid_parallel_interval(Home home, int nVoices, int forbiddenParallelInterval, int currentPosition, int voice1ID,
-                              int voice2ID, IntVarArray voicesHarmonicIntervals, IntVarArray FullChordsVoicing) {
+                              int voice2ID, IntVarArray voicesIntervalClasses, IntVarArray FullChordsVoicing) {
 
     /// harmonicIntervalForbidden is true if the interval is forbiddenParallelInterval
     BoolVar harmonicIntervalForbidden(home, 0, 1);
-    rel(home, harmonicIntervalForbidden, IRT_EQ, expr(home, voicesHarmonicIntervals[currentPosition] %
-                                                            PERFECT_OCTAVE == forbiddenParallelInterval));
+    rel(home, harmonicIntervalForbidden, IRT_EQ, expr(home, voicesIntervalClasses[currentPosition] ==
+                                                            forbiddenParallelInterval));
 
     /// notesLowerVoiceEqual is true if voice1 is the same note in both chords
     BoolVar notesLowerVoiceEqual(home, 0, 1);
@@ -104,7 +106,7 @@ void forbid_parallel_interval(Home home, int nVoices, int forbiddenParallelInter
     /// nextIntervalNotParallel is true if the harmonic interval between the voices is not forbidden
     BoolVar nextIntervalNotParallel(home, 0,1);
     rel(home, nextIntervalNotParallel, IRT_EQ,
-        expr(home, voicesHarmonicIntervals[currentPosition+1] % PERFECT_OCTAVE != forbiddenParallelInterval));
+        expr(home, voicesIntervalClasses[currentPosition+1] != forbiddenParallelInterval));
 
     /// isNextIntervalValid is true if the next interval is not parallel or if the both voices are equal in the 2 chords
     BoolVar isNextIntervalValid(home,0,1);
@@ -151,35 +153,37 @@ void contrary_motion_to_bass(const Home& home, int currentPosition, const IntVar
  * Sets the constraint for a fifth degree followed by a sixth degree in fundamental state
  *      the seventh of the scale must rise to the tonic and the other voices are going down (except for the bass)
  * @param home the instance of the problem
+ * @param nVoices the number of voices in the piece
  * @param currentPosition the current position in the chord progression
  * @param tonality the tonality of the piece
- * @param fullChordsVoicing the array containing the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  * @param tenorMelodicInterval the melodic intervals of the tenor
  * @param altoMelodicInterval the melodic intervals of the alto
  * @param sopranoMelodicInterval the melodic intervals of the soprano
  */
-void interrupted_cadence(const Home &home, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void interrupted_cadence(const Home &home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                          const IntVarArray &tenorMelodicInterval, const IntVarArray &altoMelodicInterval,
                          const IntVarArray &sopranoMelodicInterval) {
     // @todo make it cleaner with loops
+    IntVarArgs currentChordNotes = pitchClasses.slice(nVoices * currentPosition, 1, nVoices);
     /// if the mode is major, then this rule only applies to the soprano voice. Otherwise, it applies for all voices
     /// soprano note is the seventh of the scale -> that voice must raise to the tonic by a minor second
-    auto leadingTone = tonality->get_tonic() + MAJOR_SEVENTH % PERFECT_OCTAVE;
+    auto leadingTone = (tonality->get_tonic() + MAJOR_SEVENTH) % PERFECT_OCTAVE;
 
     /// If the leading tone is in the soprano, it must rise to the tonic regardless of the mode
     rel(home,
-        expr(home, fullChordsVoicing[currentPosition +  SOPRANO] % PERFECT_OCTAVE == leadingTone),
+        expr(home, currentChordNotes[SOPRANO] == leadingTone),
         BOT_IMP,
         expr(home, sopranoMelodicInterval[currentPosition] ==1),
 true);
     /// If the leading tone is in the soprano, other voices must go down (except for the bass which goes up by default)
     rel(home,
-        expr(home,fullChordsVoicing[currentPosition +  SOPRANO] % PERFECT_OCTAVE == leadingTone),
+        expr(home,currentChordNotes[SOPRANO] == leadingTone),
          BOT_IMP,
          expr(home, tenorMelodicInterval[currentPosition] < 0),
  true);
     rel(home,
-        expr(home, fullChordsVoicing[currentPosition +  SOPRANO] % PERFECT_OCTAVE == leadingTone),
+        expr(home, currentChordNotes[SOPRANO] == leadingTone),
         BOT_IMP,
         expr(home, altoMelodicInterval[currentPosition] < 0),
 true);
@@ -188,30 +192,30 @@ true);
     if(tonality->get_mode() == MINOR_MODE){
         /// tenor note is the leading tone -> that voice must raise to the tonic by a minor second
         rel(home,
-            expr(home, fullChordsVoicing[currentPosition +  TENOR] % PERFECT_OCTAVE == leadingTone),
+            expr(home, currentChordNotes[TENOR] == leadingTone),
             BOT_IMP,
             expr(home, tenorMelodicInterval[currentPosition] ==1 ),
     true);
         /// other voices must go down
         rel(home,
-            expr(home, fullChordsVoicing[currentPosition +  TENOR] % PERFECT_OCTAVE == leadingTone),
+            expr(home, currentChordNotes[TENOR] == leadingTone),
             BOT_IMP,
             expr(home, altoMelodicInterval[currentPosition] < 0),
     true);
-        rel(home, expr(home, fullChordsVoicing[currentPosition +  TENOR] % PERFECT_OCTAVE ==
+        rel(home, expr(home, currentChordNotes[TENOR] ==
                 tonality->get_degree_note(SEVENTH_DEGREE)),BOT_IMP,
             expr(home, sopranoMelodicInterval[currentPosition] < 0), true);
 
         // alto note is the seventh of the scale
         // -> that voice must raise to the tonic by a minor second
-        rel(home, expr(home, fullChordsVoicing[currentPosition +  ALTO] % PERFECT_OCTAVE ==
+        rel(home, expr(home, currentChordNotes[ALTO] ==
                 tonality->get_degree_note(SEVENTH_DEGREE)),BOT_IMP,
             expr(home, altoMelodicInterval[currentPosition] ==1 ), true);
         // other voices must go down
-        rel(home, expr(home, fullChordsVoicing[currentPosition +  ALTO] % PERFECT_OCTAVE ==
+        rel(home, expr(home, currentChordNotes[ALTO] ==
                 tonality->get_degree_note(SEVENTH_DEGREE)),BOT_IMP,
             expr(home, tenorMelodicInterval[currentPosition] < 0), true);
-        rel(home, expr(home, fullChordsVoicing[currentPosition +  ALTO] % PERFECT_OCTAVE ==
+        rel(home, expr(home, currentChordNotes[ALTO] ==
                 tonality->get_degree_note(SEVENTH_DEGREE)),BOT_IMP,
             expr(home, sopranoMelodicInterval[currentPosition] < 0), true);
     }
@@ -223,26 +227,26 @@ true);
  * @param nOfVoices
  * @param currentPosition
  * @param tonality
- * @param fullChordsVoicing
+ * @param pitchClasses
  * @param bassMelodicIntervals
  * @param tenorMelodicIntervals
  * @param altoMelodicIntervals
  * @param sopranoMelodicIntervals
  */
-void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                              const IntVarArray &bassMelodicIntervals, const IntVarArray &tenorMelodicIntervals,
                              const IntVarArray &altoMelodicIntervals, const IntVarArray &sopranoMelodicIntervals) {
-    IntVarArgs currentChord = fullChordsVoicing.slice(nOfVoices * currentPosition, 1, nOfVoices);
+    IntVarArgs currentChordNotes = pitchClasses.slice(nOfVoices * currentPosition, 1, nOfVoices);
 
     vector<IntVarArray> melodicIntervals(
             {bassMelodicIntervals, tenorMelodicIntervals, altoMelodicIntervals, sopranoMelodicIntervals});
 
     for(int voice = TENOR; voice <= SOPRANO; voice++) {
         /// third of the chord goes up by step or down by half step
-        rel(home, expr(home, currentChord[voice] % PERFECT_OCTAVE == tonality->get_tonic()), BOT_IMP,
+        rel(home, expr(home, currentChordNotes[voice] == tonality->get_tonic()), BOT_IMP,
         expr(home, melodicIntervals[voice][currentPosition] == -MINOR_SECOND || melodicIntervals[voice][currentPosition] == MAJOR_SECOND), true);
 
-        rel(home, expr(home, currentChord[voice] % PERFECT_OCTAVE ==
+        rel(home, expr(home, currentChordNotes[voice] ==
             (tonality->get_degree_note(AUGMENTED_SIXTH) + MINOR_SIXTH) % PERFECT_OCTAVE), BOT_IMP,
         expr(home, melodicIntervals[voice][currentPosition] == -MINOR_SECOND), true);
     }
@@ -264,15 +268,15 @@ void italian_augmented_sixth(const Home &home, int nOfVoices, int currentPositio
  *
  **/
 void species_seventh(const Home &home, int nOfVoices, int currentPosition, Tonality* tonality, vector<int> chordDegrees, vector<int> chordQualities,
-    IntVarArray fullChordsVoicing){
+    IntVarArray pitchClasses){
         auto next_chord_seventh = (tonality->get_degree_note(chordDegrees[currentPosition+1]) +
             get_interval_from_root(chordQualities[currentPosition+1],SEVENTH)) % PERFECT_OCTAVE;
 
-IntVarArgs currentChord = fullChordsVoicing.slice(nOfVoices * currentPosition, 1, nOfVoices);
-IntVarArgs nextChord = fullChordsVoicing.slice(nOfVoices * (currentPosition+1), 1, nOfVoices);
+IntVarArgs currentChordNotes = pitchClasses.slice(nOfVoices * currentPosition, 1, nOfVoices);
+IntVarArgs nextChordNotes = pitchClasses.slice(nOfVoices * (currentPosition+1), 1, nOfVoices);
 for (int j = BASS; j <= SOPRANO; j++) {
-    rel(home, expr(home, currentChord[j] % PERFECT_OCTAVE == next_chord_seventh), BOT_EQV,
-        expr(home, nextChord[j] % PERFECT_OCTAVE == next_chord_seventh), true);
+    rel(home, expr(home, currentChordNotes[j] == next_chord_seventh), BOT_EQV,
+        expr(home, nextChordNotes[j] == next_chord_seventh), true);
 }
     }
 
@@ -283,28 +287,28 @@ for (int j = BASS; j <= SOPRANO; j++) {
  * @param nVoices the number of voices in the piece
  * @param currentPosition the current position in the chord progression
  * @param tonality the tonality of the piece
- * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  * @param bassMelodicInterval the melodic interval of the bass between the current position and the next
  * @param tenorMelodicInterval the melodic interval of the tenor between the current position and the next
  * @param altoMelodicInterval the melodic interval of the alto between the current position and the next
  * @param sopranoMelodicInterval the melodic interval of the soprano between the current position and the next
  */
-void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray fullChordsVoicing,
+void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition, Tonality *tonality, IntVarArray pitchClasses,
                               IntVarArray bassMelodicInterval, const IntVarArray& tenorMelodicInterval,
                               const IntVarArray& altoMelodicInterval, const IntVarArray& sopranoMelodicInterval){
-    IntVarArgs currentChord = fullChordsVoicing.slice(nVoices * currentPosition, 1, nVoices);
+    IntVarArgs currentChordNotes = pitchClasses.slice(nVoices * currentPosition, 1, nVoices);
 
     vector<IntVarArray> melodicIntervals(
             {bassMelodicInterval, tenorMelodicInterval, altoMelodicInterval, sopranoMelodicInterval});
     /// appogiatura of the fifth degree: the fundamental and third of the I chord must go down
     for(int voice = TENOR; voice <= SOPRANO; voice++){
         /// the fundamental of the tonality must go down by a half step
-        rel(home, expr(home, currentChord[voice] % PERFECT_OCTAVE == tonality->get_tonic()), BOT_IMP,
+        rel(home, expr(home, currentChordNotes[voice] == tonality->get_tonic()), BOT_IMP,
             expr(home, melodicIntervals[voice][currentPosition] == -MINOR_SECOND), true);
         /// the third of the scale must go down to the second by step
-        rel(home, expr(home, currentChord[voice] % PERFECT_OCTAVE == tonality->get_degree_note(THIRD_DEGREE)),
+        rel(home, expr(home, currentChordNotes[voice] == tonality->get_degree_note(THIRD_DEGREE)),
                        BOT_IMP, expr(home, melodicIntervals[voice][currentPosition] < UNISSON), true);
-        rel(home, expr(home, currentChord[voice] % PERFECT_OCTAVE == tonality->get_degree_note(THIRD_DEGREE)),
+        rel(home, expr(home, currentChordNotes[voice] == tonality->get_degree_note(THIRD_DEGREE)),
             BOT_IMP, expr(home, melodicIntervals[voice][currentPosition] >= -MAJOR_SECOND), true);
     }
     if (currentPosition > 0){ /// if it is not the first chord in the progression
@@ -312,7 +316,7 @@ void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition
         BoolVar bassRises = expr(home, bassMelodicInterval[currentPosition-1] >= 0);
         for(int voice = TENOR; voice <= SOPRANO; voice++){
             /// if the voice is playing the tonic and the bass rises, this voice must go down or stay the same
-            rel(home, expr(home, fullChordsVoicing[currentPosition * nVoices + voice] % PERFECT_OCTAVE ==
+            rel(home, expr(home, pitchClasses[currentPosition * nVoices + voice] ==
                     tonality->get_tonic()), BOT_IMP, expr(home, melodicIntervals[voice][currentPosition - 1] <= 0), bassRises);
         }
     }
@@ -338,14 +342,14 @@ void fifth_degree_appogiatura(const Home& home, int nVoices, int currentPosition
  * @param tenorMelodicIntervals the melodic interval of the tenor between the current position and the next
  * @param altoMelodicIntervals the melodic interval of the alto between the current position and the next
  * @param sopranoMelodicIntervals the melodic interval of the soprano between the current position and the next
- * @param fullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param pitchClasses the pitch classes of all the notes of the chords in the progression
  */
 void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tonality *tonality, vector<int> chordDegs,
                         vector<int> chordQuals, vector<int> chordStas, const IntVarArray &bassMelodicIntervals,
                         const IntVarArray &tenorMelodicIntervals, const IntVarArray &altoMelodicIntervals,
-                        const IntVarArray &sopranoMelodicIntervals, IntVarArray fullChordsVoicing) {
+                        const IntVarArray &sopranoMelodicIntervals, IntVarArray pitchClasses) {
 
-    IntVarArgs currentChord (fullChordsVoicing.slice(nVoices * currentPosition, 1, nVoices));
+    IntVarArgs currentChordNotes (pitchClasses.slice(nVoices * currentPosition, 1, nVoices));
     vector<IntVarArray> melodicIntervals({bassMelodicIntervals, tenorMelodicIntervals, altoMelodicIntervals, sopranoMelodicIntervals});
 
     if (chordDegs[currentPosition] == FIFTH_DEGREE || chordDegs[currentPosition] == SEVENTH_DEGREE) {
@@ -360,7 +364,7 @@ void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tona
                 /// the fourth of the scale must go up by a step
                 rel(home,
                     /// the note in this voice is the fourth of the scale
-                    expr(home,currentChord[voice] % PERFECT_OCTAVE == (tonality->get_tonic() + PERFECT_FOURTH) % PERFECT_OCTAVE),
+                    expr(home,currentChordNotes[voice] == (tonality->get_tonic() + PERFECT_FOURTH) % PERFECT_OCTAVE),
                     BOT_IMP,
                     /// it must go up by step
                     expr(home, expr(home, melodicIntervals[voice][currentPosition] > 0) && expr(home, melodicIntervals[voice][currentPosition] <= 2)),
@@ -369,7 +373,7 @@ void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tona
             else{ /// the fourth of the scale must go down by a step
                 rel(home,
                     /// the note is the fourth of the scale
-                    expr(home, currentChord[voice] % PERFECT_OCTAVE == (tonality->get_tonic() + PERFECT_FOURTH) % PERFECT_OCTAVE),
+                    expr(home, currentChordNotes[voice] == (tonality->get_tonic() + PERFECT_FOURTH) % PERFECT_OCTAVE),
                     BOT_IMP,
                     /// it must go down by step
                     expr(home, expr(home, melodicIntervals[voice][currentPosition] < 0) && expr(home, melodicIntervals[voice][currentPosition] >= -2)),
@@ -377,7 +381,7 @@ void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tona
             }
             /// if the note is the leading tone of the scale, it must go up to the tonic by step
             rel(home,
-                expr(home, currentChord[voice] % PERFECT_OCTAVE == (tonality->get_tonic() + MAJOR_SEVENTH) % PERFECT_OCTAVE),
+                expr(home, currentChordNotes[voice] == (tonality->get_tonic() + MAJOR_SEVENTH) % PERFECT_OCTAVE),
                 BOT_IMP,
                 expr(home, melodicIntervals[voice][currentPosition] == 1),
                 true);
@@ -390,14 +394,14 @@ void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tona
         for(int voice = BASS; voice <= SOPRANO; voice++) {
             rel(home,
                         /// the note is the seventh of the chord
-                        expr(home, currentChord[voice] % PERFECT_OCTAVE == seventh),
+                        expr(home, currentChordNotes[voice] == seventh),
                         BOT_IMP,
                         /// it must go down by step
                         expr(home, expr(home, melodicIntervals[voice][currentPosition] < 0) && expr(home, melodicIntervals[voice][currentPosition] >= -2)),
                 true);
             rel(home,
                         /// the note is the third of the chord
-                        expr(home, currentChord[voice] % PERFECT_OCTAVE == third),
+                        expr(home, currentChordNotes[voice] == third),
                         BOT_IMP,
                         /// it must go up by step
                         expr(home, melodicIntervals[voice][currentPosition] == 1),
@@ -406,3 +410,18 @@ void tritone_resolution(const Home &home, int nVoices, int currentPosition, Tona
     }
 }
 
+/**
+ * Restrains two consecutive chords to the legal transitions between them with a single table constraint, which replaces
+ * all the other voice leading constraints between the two chords
+ * @param home the instance of the problem
+ * @param currentPosition the current position in the chord progression
+ * @param nOfVoices the number of voices
+ * @param FullChordsVoicing the array containing all the notes of the chords in the progression
+ * @param table the legal transitions, in the form [bass, tenor, alto, soprano, nextBass, nextTenor, nextAlto,
+ * nextSoprano] (see VoicingRules::transition_table)
+ */
+void legal_transitions(const Home &home, int currentPosition, int nOfVoices, IntVarArray FullChordsVoicing,
+                       const TupleSet &table){
+    IntVarArgs chords(FullChordsVoicing.slice(nOfVoices * currentPosition, 1, 2 * nOfVoices));
+    extensional(home, chords, table);
+}
@@ -0,0 +1,77 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A process-wide cache of the legal voicings of each chord, so that they are enumerated only once for
+//                each chord signature.
+//
+#include <tuple>
+
+#include "../../headers/diatony/VoicingCache.hpp"
+
+/**
+ * Compares two chord signatures in lexicographical order of their fields
+ * @param other another chord signature
+ * @return true if this signature comes before the other one
+ */
+bool ChordSignature::operator<(const ChordSignature &other) const {
+    return std::tie(tonic, mode, degree, quality, state, context) <
+           std::tie(other.tonic, other.mode, other.degree, other.quality, other.state, other.context);
+}
+
+std::mutex VoicingCache::lock;
+map<ChordSignature, vector<PackedVoicing>> VoicingCache::voicings;
+
+/**
+ * Packs a voicing in 4 bytes
+ * @param voicing a chord in the form [bass, tenor, alto, soprano] with MIDI values in [0,127]
+ * @return the packed voicing
+ */
+PackedVoicing VoicingCache::pack(const vector<int> &voicing) {
+    PackedVoicing packed = 0;
+    for(int voice = SOPRANO; voice >= BASS; voice--)
+        packed = (packed << 8) | (PackedVoicing) voicing[voice];
+    return packed;
+}
+
+/**
+ * Unpacks a voicing
+ * @param packed a packed voicing
+ * @return the chord in the form [bass, tenor, alto, soprano]
+ */
+vector<int> VoicingCache::unpack(PackedVoicing packed) {
+    vector<int> voicing(4);
+    for(int voice = BASS; voice <= SOPRANO; voice++){
+        voicing[voice] = (int) (packed & 0xFF);
+        packed >>= 8;
+    }
+    return voicing;
+}
+
+/**
+ * Returns the legal voicings of a chord signature, enumerating them the first time the signature is met
+ * @param signature the signature of the chord
+ * @param enumerate a function enumerating the legal voicings of the chord
+ * @return the packed legal voicings of the chord, sorted by bass, then tenor, alto and soprano
+ */
+const vector<PackedVoicing>& VoicingCache::get(const ChordSignature &signature,
+                                               const function<vector<PackedVoicing>()> &enumerate) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = voicings.find(signature);
+        if(it != voicings.end())
+            return it->second;
+    }
+    /// the enumeration is done without holding the lock. If two threads enumerate the same signature, the first one
+    /// to finish is kept
+    vector<PackedVoicing> enumerated = enumerate();
+    std::lock_guard<std::mutex> guard(lock);
+    return voicings.insert(std::make_pair(signature, std::move(enumerated))).first->second;
+}
+
+/**
+ * Returns the number of chord signatures in the cache
+ * @return the number of signatures whose voicings have been enumerated
+ */
+int VoicingCache::get_size() {
+    std::lock_guard<std::mutex> guard(lock);
+    return voicings.size();
+}
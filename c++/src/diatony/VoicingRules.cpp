@@ -0,0 +1,730 @@
+// Programmer:    Damien Sprockeels <damien.sprockeels@uclouvain.be>
+// Creation Date: Oct 16 2026
+// Description:   A class that evaluates the rules of the four voice texture problem on explicit voicings and solves the
+//                problem exactly by dynamic programming over the legal voicings of each chord.
+//
+#include "../../headers/diatony/VoicingRules.hpp"
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                  Auxiliary functions                                                *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+
+/**
+ * Returns the bit mask of the melodic intervals in [lowest, highest]
+ * @param lowest the lowest allowed melodic interval
+ * @param highest the highest allowed melodic interval
+ * @return a mask where bit (interval + PERFECT_OCTAVE) is set for each allowed interval
+ */
+static unsigned int interval_mask(int lowest, int highest){
+    unsigned int mask = 0;
+    for(int interval = lowest; interval <= highest; interval++)
+        mask |= 1U << (interval + PERFECT_OCTAVE);
+    return mask;
+}
+
+/**
+ * Returns the number of voices playing a given note, regardless of its octave
+ * @param voicing a chord in the form [bass, tenor, alto, soprano]
+ * @param note a note in [0,11]
+ * @return the number of occurrences of the note in the chord
+ */
+static int count_note(const vector<int> &voicing, int note){
+    int n = 0;
+    for(int v : voicing)
+        if(v % PERFECT_OCTAVE == note)
+            n++;
+    return n;
+}
+
+/**
+ * Returns the number of different values in a chord
+ * @param voicing a chord in the form [bass, tenor, alto, soprano]
+ * @param modulo PERFECT_OCTAVE to count the notes regardless of their octave, 0 to count the MIDI values
+ * @return the number of different values
+ */
+static int n_of_different_values(const vector<int> &voicing, int modulo){
+    set<int> values;
+    for(int v : voicing)
+        values.insert(modulo == 0 ? v : v % modulo);
+    return (int) values.size();
+}
+
+/**
+ * Adds two cost vectors element-wise
+ * @param a a cost vector
+ * @param b a cost vector
+ * @return the sum of the two cost vectors
+ */
+static VoicingRules::LexCost add_costs(const VoicingRules::LexCost &a, const VoicingRules::LexCost &b){
+    VoicingRules::LexCost sum{};
+    for(int i = 0; i < N_OF_COSTS; i++)
+        sum[i] = a[i] + b[i];
+    return sum;
+}
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                                                                                     *
+ *                                               VoicingRules class methods                                            *
+ *                                                                                                                     *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+
+/**
+ * Constructor
+ * @param s the number of chords in the progression
+ * @param t a pointer to a Tonality object
+ * @param chordDegs the degrees of the chord of the chord progression
+ * @param chordQuals the qualities of the chord of the chord progression
+ * @param chordStas the states of the chord of the chord progression (fundamental, 1st inversion,...)
+ * @return an instance of VoicingRules with the rules of each chord and between each chord precomputed
+ */
+VoicingRules::VoicingRules(int s, Tonality *t, vector<int> chordDegs, vector<int> chordQuals, vector<int> chordStas) {
+    size                = s;
+    tonality            = t;
+    chordDegrees        = std::move(chordDegs);
+    chordQualities      = std::move(chordQuals);
+    chordStates         = std::move(chordStas);
+
+    isChordNote         = vector<vector<bool>>(size, vector<bool>(PERFECT_OCTAVE, false));
+    bassNotes           = vector<int>(size);
+    nOfNotesInChord     = vector<int>(size);
+    thirdNotes          = vector<int>(size);
+    rootNotes           = vector<int>(size);
+    noteOccurrences     = vector<vector<NoteOccurrence>>(size);
+    conditionalDoubling = vector<int>(size, NO_CONDITIONAL_DOUBLING);
+    isFundStateDiminished = vector<bool>(size, false);
+
+    for(int i = 0; i < size; i++){
+        /// the doubling rules are computed first as they reject invalid states
+        set_note_occurrences(i);
+
+        /// notes of the chord (set_to_chord)
+        int note = tonality->get_degree_note(chordDegrees[i]) % PERFECT_OCTAVE;
+        isChordNote[i][note] = true;
+        for(int interval : chordQualitiesIntervals.at(chordQualities[i]))
+            isChordNote[i][(note += interval) % PERFECT_OCTAVE] = true;
+        nOfNotesInChord[i] = chordQualitiesIntervals.at(chordQualities[i]).size() + 1;
+
+        /// bass of the chord (set_bass)
+        bassNotes[i] = (tonality->get_degree_note(chordDegrees[i]) +
+                get_interval_from_root(chordQualities[i], chordStates[i])) % PERFECT_OCTAVE;
+
+        isFundStateDiminished[i] = chordQualities[i] == DIMINISHED_CHORD && chordStates[i] == FUNDAMENTAL_STATE;
+    }
+
+    forbidsParallels        = vector<bool>(max(size - 1, 0), false);
+    motionRules             = vector<vector<MotionRule>>(max(size - 1, 0));
+    preparedSeventh         = vector<int>(max(size - 1, 0), -1);
+    contraryMotionToBass    = vector<bool>(max(size - 1, 0), false);
+    appogiaturaApproach     = vector<bool>(max(size - 1, 0), false);
+    for(int i = 0; i < size - 1; i++)
+        set_transition_rules(i);
+}
+
+/**
+ * Computes the doubling rules of a chord depending on its state. Mirrors the chord_note_occurrence functions
+ * @param pos the position of the chord in the progression
+ */
+void VoicingRules::set_note_occurrences(int pos) {
+    int degree = chordDegrees[pos];
+    int quality = chordQualities[pos];
+    int state = chordStates[pos];
+
+    if(state == THIRD_INVERSION && quality < DOMINANT_SEVENTH_CHORD)
+        throw std::invalid_argument("The chord cannot be in third inversion");
+
+    int root = tonality->get_degree_note(degree);
+    int third = (root + get_interval_from_root(quality, THIRD)) % PERFECT_OCTAVE;
+    int fifth = (root + get_interval_from_root(quality, FIFTH)) % PERFECT_OCTAVE;
+    int seventh = quality >= DOMINANT_SEVENTH_CHORD ?
+            (root + get_interval_from_root(quality, SEVENTH)) % PERFECT_OCTAVE : -1;
+    rootNotes[pos] = root % PERFECT_OCTAVE;
+    thirdNotes[pos] = third;
+
+    vector<NoteOccurrence> &occ = noteOccurrences[pos];
+    bool isDominant = degree == FIFTH_DEGREE || (degree >= FIVE_OF_TWO && degree <= FIVE_OF_SEVEN);
+
+    if(state == FUNDAMENTAL_STATE){
+        if(degree == SEVENTH_DEGREE && quality == DIMINISHED_CHORD){
+            conditionalDoubling[pos] = DIMINISHED_DOUBLED_THIRD;
+            occ = {{root, 1, nOfVoices}, {third, 1, nOfVoices}, {fifth, 1, nOfVoices}};
+        }
+        else if(degree == FLAT_TWO)
+            occ = {{root, 1, 1}, {third, 2, 2}, {fifth, 1, nOfVoices}};
+        else if(degree == AUGMENTED_SIXTH)
+            occ = {{root, 1, 1}, {third, 2, 2}, {fifth, 1, 1}};
+        else if(degree == SIXTH_DEGREE && pos > 0 && chordDegrees[pos - 1] == FIFTH_DEGREE)
+            occ = {{root, 1, 1}, {third, 2, 2}, {fifth, 1, 1}};
+        else if(isDominant){
+            occ = {{root, 1, nOfVoices}, {third, 1, 1}, {fifth, 0, 1}};
+            if(quality >= DOMINANT_SEVENTH_CHORD){
+                occ.push_back({seventh, 1, 1});
+                conditionalDoubling[pos] = INCOMPLETE_DOUBLED_ROOT;
+            }
+        }
+        else if(degree == FIRST_DEGREE){
+            occ = {{root, 1, nOfVoices}, {third, 1, 1}, {fifth, 0, 1}};
+            conditionalDoubling[pos] = INCOMPLETE_TRIPLED_ROOT;
+            if(quality >= DOMINANT_SEVENTH_CHORD)
+                occ.push_back({seventh, 1, 1});
+        }
+        else{
+            occ = {{root, 1, nOfVoices}, {third, 1, 1}, {fifth, 0, 1}};
+            if(quality >= DOMINANT_SEVENTH_CHORD)
+                occ.push_back({seventh, 1, 1});
+            else
+                occ.push_back({fifth, 1, 1});
+        }
+    }
+    else if(state == FIRST_INVERSION){
+        const set<int> &tonalNotes = tonality->get_tonal_notes();
+        if(tonalNotes.find(third) != tonalNotes.end())
+            occ.push_back({third, 2, 2});
+        else if((degree == SEVENTH_DEGREE && quality == DIMINISHED_CHORD) || degree == FLAT_TWO)
+            occ.push_back({third, 2, 2});
+        else if(isDominant && quality == DIMINISHED_SEVENTH_CHORD){
+            /// minor ninth dominant chord without its root
+            for(int interval = MINOR_THIRD; interval <= PERFECT_OCTAVE; interval += MINOR_THIRD)
+                occ.push_back({(root + interval) % PERFECT_OCTAVE, 1, 1});
+        }
+        else if(pos > 0 && pos < size - 1){
+            /// the exact number of thirds depends on the motion of the outer voices around the chord
+            conditionalDoubling[pos] = CONTRARY_MOTION_DOUBLED_THIRD;
+            occ.push_back({third, 1, 2});
+        }
+        else
+            occ.push_back({root, 1, 1});
+
+        if(quality != MINOR_NINTH_DOMINANT_CHORD)
+            occ.push_back({root, 1, nOfVoices});
+        occ.push_back({third, 1, nOfVoices});
+        occ.push_back({fifth, 1, nOfVoices});
+        if(quality >= DOMINANT_SEVENTH_CHORD)
+            occ.push_back({seventh, 1, nOfVoices});
+    }
+    else if(state == SECOND_INVERSION){
+        if(degree == SEVENTH_DEGREE && quality == DIMINISHED_CHORD)
+            occ = {{root, 1, 1}, {third, 2, 2}, {fifth, 1, 1}};
+        else{
+            occ = {{root, 1, 1}, {third, 1, 1}, {fifth, 1, nOfVoices}};
+            if(quality >= DOMINANT_SEVENTH_CHORD)
+                occ.push_back({seventh, 1, 1});
+        }
+    }
+    else if(state == THIRD_INVERSION){
+        occ = {{root, 1, 1}, {third, 1, 1}, {fifth, 1, nOfVoices}, {seventh, 1, 1}};
+    }
+}
+
+/**
+ * Computes the rules between a chord and the next one. Mirrors the melodic constraints posted by FourVoiceTexture
+ * @param pos the position of the first chord in the progression
+ */
+void VoicingRules::set_transition_rules(int pos) {
+    int tonic = tonality->get_tonic();
+    vector<MotionRule> &rules = motionRules[pos];
+
+    /// parallel unissons, fifths and octaves are forbidden unless we have the same chord twice in a row
+    forbidsParallels[pos] = chordDegrees[pos] != chordDegrees[pos + 1];
+
+    /// resolve the tritone if there is one and it needs to be resolved (tritone_resolution)
+    if((chordDegrees[pos] == SEVENTH_DEGREE && chordQualities[pos] == DIMINISHED_CHORD && chordDegrees[pos + 1] == FIRST_DEGREE) ||
+       (chordDegrees[pos] == FIFTH_DEGREE && chordDegrees[pos + 1] == FIRST_DEGREE) ||
+       ((chordDegrees[pos] >= FIVE_OF_TWO && chordDegrees[pos] <= FIVE_OF_SEVEN) && chordDegrees[pos + 1] != FIFTH_DEGREE_APPOGIATURA)){
+        if(chordDegrees[pos] == FIFTH_DEGREE || chordDegrees[pos] == SEVENTH_DEGREE){
+            bool fourthRises =
+                    (chordDegrees[pos] == SEVENTH_DEGREE && chordStates[pos] == FIRST_INVERSION &&
+                     chordDegrees[pos + 1] == FIRST_DEGREE && chordStates[pos + 1] == FIRST_INVERSION) ||
+                    (chordDegrees[pos] == FIFTH_DEGREE && chordQualities[pos] == DOMINANT_SEVENTH_CHORD &&
+                     chordStates[pos] == SECOND_INVERSION &&
+                     chordDegrees[pos + 1] == FIRST_DEGREE && chordStates[pos + 1] == FIRST_INVERSION);
+            int fourth = (tonic + PERFECT_FOURTH) % PERFECT_OCTAVE;
+            int leadingTone = (tonic + MAJOR_SEVENTH) % PERFECT_OCTAVE;
+            for(int voice = BASS; voice <= SOPRANO; voice++){
+                rules.push_back({voice, fourth, voice, fourthRises ? interval_mask(1, MAJOR_SECOND) :
+                                                                     interval_mask(-MAJOR_SECOND, -1)});
+                rules.push_back({voice, leadingTone, voice, interval_mask(MINOR_SECOND, MINOR_SECOND)});
+            }
+        }
+        else{ /// secondary dominant chords
+            int third = (tonality->get_degree_note(chordDegrees[pos]) + MAJOR_THIRD) % PERFECT_OCTAVE;
+            int seventh = (tonality->get_degree_note(chordDegrees[pos]) + MINOR_SEVENTH) % PERFECT_OCTAVE;
+            for(int voice = BASS; voice <= SOPRANO; voice++){
+                rules.push_back({voice, seventh, voice, interval_mask(-MAJOR_SECOND, -1)});
+                rules.push_back({voice, third, voice, interval_mask(MINOR_SECOND, MINOR_SECOND)});
+            }
+        }
+    }
+
+    unsigned int down = interval_mask(-PERFECT_OCTAVE, -1);
+    unsigned int halfStepUp = interval_mask(MINOR_SECOND, MINOR_SECOND);
+
+    /// special rule for interrupted cadence (interrupted_cadence)
+    if(chordDegrees[pos] == FIFTH_DEGREE && chordStates[pos] == FUNDAMENTAL_STATE &&
+       chordDegrees[pos + 1] == SIXTH_DEGREE && chordStates[pos + 1] == FUNDAMENTAL_STATE){
+        int leadingTone = (tonic + MAJOR_SEVENTH) % PERFECT_OCTAVE;
+        rules.push_back({SOPRANO, leadingTone, SOPRANO, halfStepUp});
+        rules.push_back({SOPRANO, leadingTone, TENOR, down});
+        rules.push_back({SOPRANO, leadingTone, ALTO, down});
+        if(tonality->get_mode() == MINOR_MODE){
+            int seventhDegree = tonality->get_degree_note(SEVENTH_DEGREE);
+            rules.push_back({TENOR, leadingTone, TENOR, halfStepUp});
+            rules.push_back({TENOR, leadingTone, ALTO, down});
+            rules.push_back({TENOR, seventhDegree, SOPRANO, down});
+            rules.push_back({ALTO, seventhDegree, ALTO, halfStepUp});
+            rules.push_back({ALTO, seventhDegree, TENOR, down});
+            rules.push_back({ALTO, seventhDegree, SOPRANO, down});
+        }
+    }
+    /// special rules for augmented sixth chords (italian_augmented_sixth)
+    else if(chordDegrees[pos] == AUGMENTED_SIXTH){
+        int sixth = (tonality->get_degree_note(AUGMENTED_SIXTH) + MINOR_SIXTH) % PERFECT_OCTAVE;
+        for(int voice = TENOR; voice <= SOPRANO; voice++){
+            rules.push_back({voice, tonic, voice, interval_mask(-MINOR_SECOND, -MINOR_SECOND) |
+                                                  interval_mask(MAJOR_SECOND, MAJOR_SECOND)});
+            rules.push_back({voice, sixth, voice, interval_mask(-MINOR_SECOND, -MINOR_SECOND)});
+        }
+    }
+    /// appogiatura of the fifth degree (fifth_degree_appogiatura)
+    else if(chordDegrees[pos] == FIRST_DEGREE && chordStates[pos] == SECOND_INVERSION && chordDegrees[pos + 1] == FIFTH_DEGREE &&
+            (chordQualities[pos] == MAJOR_CHORD || chordQualities[pos] == DOMINANT_SEVENTH_CHORD)){
+        int thirdDegree = tonality->get_degree_note(THIRD_DEGREE);
+        for(int voice = TENOR; voice <= SOPRANO; voice++){
+            rules.push_back({voice, tonic, voice, interval_mask(-MINOR_SECOND, -MINOR_SECOND)});
+            rules.push_back({voice, thirdDegree, voice, interval_mask(-MAJOR_SECOND, -1)});
+        }
+        /// the tonic must be approached by direct or oblique motion
+        if(pos > 0)
+            appogiaturaApproach[pos - 1] = true;
+    }
+    /// general voice leading rules
+    else{
+        if((chordQualities[pos + 1] == MAJOR_SEVENTH_CHORD || chordQualities[pos + 1] == MINOR_SEVENTH_CHORD ||
+            chordQualities[pos + 1] == DIMINISHED_SEVENTH_CHORD || chordQualities[pos + 1] == HALF_DIMINISHED_CHORD) &&
+            chordDegrees[pos + 1] <= SEVENTH_DEGREE){
+            /// the seventh must be prepared (species_seventh)
+            preparedSeventh[pos] = (tonality->get_degree_note(chordDegrees[pos + 1]) +
+                    get_interval_from_root(chordQualities[pos + 1], SEVENTH)) % PERFECT_OCTAVE;
+        }
+        int bassFirstChord = bassNotes[pos];
+        int bassSecondChord = bassNotes[pos + 1];
+        int bassMelodicMotion = abs(bassSecondChord - bassFirstChord);
+        if((bassMelodicMotion == MINOR_SECOND || bassMelodicMotion == MAJOR_SECOND ||
+            bassMelodicMotion == MINOR_SEVENTH || bassMelodicMotion == MAJOR_SEVENTH) &&
+           (chordStates[pos] == FUNDAMENTAL_STATE && chordStates[pos + 1] == FUNDAMENTAL_STATE))
+            contraryMotionToBass[pos] = true;
+        else if(chordDegrees[pos] == SECOND_DEGREE && chordDegrees[pos + 1] == FIFTH_DEGREE)
+            contraryMotionToBass[pos] = true;
+    }
+}
+
+/**
+ * Returns the number of chords of the problem
+ * @return an integer representing the number of chords of the problem
+ */
+int VoicingRules::get_size() const { return size; }
+
+/**
+ * Returns whether the doubling of a chord depends on the motion of the outer voices into and out of the chord
+ * @param pos the position of the chord in the progression
+ * @return true if the third is doubled exactly when the bass rises and the soprano falls by step around the chord
+ */
+bool VoicingRules::depends_on_contrary_motion(int pos) const {
+    return conditionalDoubling[pos] == CONTRARY_MOTION_DOUBLED_THIRD;
+}
+
+/**
+ * Returns the number of times the third of a chord is present in a voicing
+ * @param pos the position of the chord in the progression
+ * @param voicing a chord in the form [bass, tenor, alto, soprano]
+ * @return the number of voices playing the third of the chord
+ */
+int VoicingRules::n_of_thirds(int pos, const vector<int> &voicing) const {
+    return count_note(voicing, thirdNotes[pos]);
+}
+
+/**
+ * Checks the rules that only involve a single chord: ranges, order and spacing of the voices, notes of the chord,
+ * bass note and doubling. The doubling rules depending on the surrounding motion are checked by
+ * outer_voices_contrary_step.
+ * @param pos the position of the chord in the progression
+ * @param voicing a chord in the form [bass, tenor, alto, soprano]
+ * @return true if the voicing respects the rules of the chord
+ */
+bool VoicingRules::is_legal_voicing(int pos, const vector<int> &voicing) const {
+    const vector<int> lowerBounds = {BASS_MIN, TENOR_MIN, ALTO_MIN, SOPRANO_MIN};
+    const vector<int> upperBounds = {BASS_MAX, TENOR_MAX, ALTO_MAX, SOPRANO_MAX};
+    /// ranges, order of the voices and notes of the chord
+    for(int voice = BASS; voice <= SOPRANO; voice++){
+        if(voicing[voice] < lowerBounds[voice] || voicing[voice] > upperBounds[voice])
+            return false;
+        if(voice > BASS && voicing[voice] < voicing[voice - 1])
+            return false;
+        if(!isChordNote[pos][voicing[voice] % PERFECT_OCTAVE])
+            return false;
+    }
+    if(voicing[BASS] % PERFECT_OCTAVE != bassNotes[pos])
+        return false;
+    /// maximum spacing given by the domains of the harmonic intervals
+    if(voicing[TENOR] - voicing[BASS] > PERFECT_OCTAVE + PERFECT_FIFTH ||
+       voicing[ALTO] - voicing[BASS] > 2 * PERFECT_OCTAVE + PERFECT_FIFTH ||
+       voicing[SOPRANO] - voicing[BASS] > 3 * PERFECT_OCTAVE + PERFECT_FIFTH ||
+       voicing[ALTO] - voicing[TENOR] > PERFECT_OCTAVE ||
+       voicing[SOPRANO] - voicing[TENOR] > 2 * PERFECT_OCTAVE ||
+       voicing[SOPRANO] - voicing[ALTO] > PERFECT_OCTAVE)
+        return false;
+    /// doubling
+    for(const NoteOccurrence &occ : noteOccurrences[pos]){
+        int n = count_note(voicing, occ.note);
+        if(n < occ.min || n > occ.max)
+            return false;
+    }
+    switch(conditionalDoubling[pos]){
+        case DIMINISHED_DOUBLED_THIRD:
+            return n_of_different_values(voicing, 0) != nOfVoices || count_note(voicing, thirdNotes[pos]) == 2;
+        case INCOMPLETE_DOUBLED_ROOT:
+            return (n_of_different_values(voicing, PERFECT_OCTAVE) < 4) == (count_note(voicing, rootNotes[pos]) == 2);
+        case INCOMPLETE_TRIPLED_ROOT:
+            return (n_of_different_values(voicing, PERFECT_OCTAVE) < 3) == (count_note(voicing, rootNotes[pos]) == 3);
+        default:
+            return true;
+    }
+}
+
+/**
+ * Enumerates all the voicings of a chord respecting the rules that only involve that chord
+ * @param pos the position of the chord in the progression
+ * @return the packed legal voicings, sorted by bass, then tenor, alto and soprano
+ */
+vector<PackedVoicing> VoicingRules::enumerate_voicings(int pos) const {
+    vector<PackedVoicing> voicings;
+    vector<int> voicing(nOfVoices);
+    for(int b = BASS_MIN; b <= BASS_MAX; b++){
+        if(b % PERFECT_OCTAVE != bassNotes[pos])
+            continue;
+        for(int t = max(TENOR_MIN, b); t <= min(TENOR_MAX, b + PERFECT_OCTAVE + PERFECT_FIFTH); t++){
+            if(!isChordNote[pos][t % PERFECT_OCTAVE])
+                continue;
+            for(int a = max(ALTO_MIN, t); a <= min(ALTO_MAX, t + PERFECT_OCTAVE); a++){
+                if(!isChordNote[pos][a % PERFECT_OCTAVE])
+                    continue;
+                for(int s = max(SOPRANO_MIN, a); s <= min(SOPRANO_MAX, a + PERFECT_OCTAVE); s++){
+                    voicing = {b, t, a, s};
+                    if(is_legal_voicing(pos, voicing))
+                        voicings.push_back(VoicingCache::pack(voicing));
+                }
+            }
+        }
+    }
+    return voicings;
+}
+
+/**
+ * Returns the facts about the neighbouring chords that change the doubling rules of a chord
+ * @param pos the position of the chord in the progression
+ * @return a bit set: bit 0 if the chord is a submediant chord in fundamental state following a dominant chord, bit 1
+ * if the chord is in first inversion and is neither the first nor the last chord
+ */
+int VoicingRules::doubling_context(int pos) const {
+    int context = 0;
+    if(chordStates[pos] == FUNDAMENTAL_STATE && chordDegrees[pos] == SIXTH_DEGREE && pos > 0 &&
+       chordDegrees[pos - 1] == FIFTH_DEGREE)
+        context |= 1;
+    if(chordStates[pos] == FIRST_INVERSION && pos > 0 && pos < size - 1)
+        context |= 2;
+    return context;
+}
+
+/**
+ * Returns the signature of a chord, which identifies its legal voicings in the VoicingCache
+ * @param pos the position of the chord in the progression
+ * @return the signature of the chord
+ */
+ChordSignature VoicingRules::signature(int pos) const {
+    return {tonality->get_tonic(), tonality->get_mode(), chordDegrees[pos], chordQualities[pos], chordStates[pos],
+            doubling_context(pos)};
+}
+
+/**
+ * Returns all the voicings of a chord respecting the rules that only involve that chord. They are enumerated once
+ * per chord signature and stored in the VoicingCache.
+ * @param pos the position of the chord in the progression
+ * @return the packed legal voicings, sorted by bass, then tenor, alto and soprano
+ */
+const vector<PackedVoicing>& VoicingRules::legal_packed_voicings(int pos) const {
+    return VoicingCache::get(signature(pos), [this, pos](){ return enumerate_voicings(pos); });
+}
+
+/**
+ * Returns all the voicings of a chord respecting the rules that only involve that chord
+ * @param pos the position of the chord in the progression
+ * @return a vector containing all the legal voicings in the form [bass, tenor, alto, soprano]
+ */
+vector<vector<int>> VoicingRules::legal_voicings(int pos) const {
+    const vector<PackedVoicing> &packed = legal_packed_voicings(pos);
+    vector<vector<int>> voicings;
+    voicings.reserve(packed.size());
+    for(PackedVoicing p : packed)
+        voicings.push_back(VoicingCache::unpack(p));
+    return voicings;
+}
+
+/**
+ * Checks the rules between two consecutive chords: melodic intervals, parallel intervals, tritone resolution,
+ * special cadences and preparation of sevenths
+ * @param pos the position of the first chord in the progression
+ * @param current the voicing of the chord at position pos
+ * @param next the voicing of the chord at position pos+1
+ * @return true if the transition respects the rules
+ */
+bool VoicingRules::is_legal_transition(int pos, const vector<int> &current, const vector<int> &next) const {
+    int melodicIntervals[4];
+    for(int voice = BASS; voice <= SOPRANO; voice++){
+        melodicIntervals[voice] = next[voice] - current[voice];
+        if(abs(melodicIntervals[voice]) > PERFECT_OCTAVE)
+            return false;
+    }
+    /// parallel intervals (forbid_parallel_intervals)
+    if(forbidsParallels[pos]){
+        for(int lower = BASS; lower < SOPRANO; lower++){
+            for(int upper = lower + 1; upper <= SOPRANO; upper++){
+                if(melodicIntervals[lower] == 0 && melodicIntervals[upper] == 0)
+                    continue;
+                for(int interval : {PERFECT_FIFTH, PERFECT_OCTAVE, UNISSON}){
+                    if((current[upper] - current[lower]) % PERFECT_OCTAVE == interval &&
+                       (next[upper] - next[lower]) % PERFECT_OCTAVE == interval)
+                        return false;
+                }
+            }
+        }
+    }
+    /// conditional melodic rules (tritone resolution, cadences, augmented sixth and appogiatura)
+    for(const MotionRule &rule : motionRules[pos]){
+        if(current[rule.triggerVoice] % PERFECT_OCTAVE == rule.note &&
+           !(rule.allowedIntervals & (1U << (melodicIntervals[rule.voice] + PERFECT_OCTAVE))))
+            return false;
+    }
+    /// the seventh of the next chord must be prepared in the same voice (species_seventh)
+    if(preparedSeventh[pos] != -1){
+        for(int voice = BASS; voice <= SOPRANO; voice++)
+            if((current[voice] % PERFECT_OCTAVE == preparedSeventh[pos]) != (next[voice] % PERFECT_OCTAVE == preparedSeventh[pos]))
+                return false;
+    }
+    /// other voices move in contrary motion to the bass (contrary_motion_to_bass)
+    if(contraryMotionToBass[pos]){
+        for(int voice = TENOR; voice <= SOPRANO; voice++){
+            if((melodicIntervals[BASS] > 0) != (melodicIntervals[voice] < 0) ||
+               (melodicIntervals[BASS] < 0) != (melodicIntervals[voice] > 0))
+                return false;
+        }
+    }
+    /// the tonic of the appogiatura must be approached by direct or oblique motion (fifth_degree_appogiatura)
+    if(appogiaturaApproach[pos]){
+        int tonic = tonality->get_tonic();
+        for(int voice = TENOR; voice <= SOPRANO; voice++){
+            if((melodicIntervals[BASS] >= 0) !=
+               (next[voice] % PERFECT_OCTAVE != tonic || melodicIntervals[voice] <= 0))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Enumerates all the pairs of legal voicings of a chord and the next one that respect the rules between them
+ * @param pos the position of the first chord in the progression
+ * @return the finalized table of the legal transitions, one tuple of 8 notes per pair of voicings, or a table marked
+ * as too large if there are more than MAX_TRANSITION_TUPLES of them
+ */
+TransitionTable VoicingRules::enumerate_transitions(int pos) const {
+    vector<vector<int>> currentVoicings = legal_voicings(pos);
+    vector<vector<int>> nextVoicings = legal_voicings(pos + 1);
+    TransitionTable table;
+    table.tuples = TupleSet(2 * nOfVoices);
+    IntArgs tuple(2 * nOfVoices);
+    int nOfTuples = 0;
+    for(const auto &current : currentVoicings){
+        for(const auto &next : nextVoicings){
+            if(!is_legal_transition(pos, current, next))
+                continue;
+            /// a table this large costs more memory and construction time than the propagators it replaces
+            if(++nOfTuples > MAX_TRANSITION_TUPLES){
+                table.tuples = TupleSet();
+                table.tooLarge = true;
+                return table;
+            }
+            for(int voice = BASS; voice <= SOPRANO; voice++){
+                tuple[voice] = current[voice];
+                tuple[nOfVoices + voice] = next[voice];
+            }
+            table.tuples.add(tuple);
+        }
+    }
+    table.tuples.finalize();
+    return table;
+}
+
+/**
+ * Returns the facts about the chord after a pair of chords that change the rules between them
+ * @param pos the position of the first chord in the progression
+ * @return 1 if the second chord is the appogiatura of a dominant chord, which must be approached by direct or
+ * oblique motion, 0 otherwise
+ */
+int VoicingRules::transition_context(int pos) const {
+    return appogiaturaApproach[pos] ? 1 : 0;
+}
+
+/**
+ * Returns the signature of a pair of consecutive chords, which identifies its table in the TransitionTableCache
+ * @param pos the position of the first chord in the progression
+ * @return the signature of the pair of chords
+ */
+TransitionSignature VoicingRules::transition_signature(int pos) const {
+    return {signature(pos), signature(pos + 1), transition_context(pos)};
+}
+
+/**
+ * Returns the table of the legal transitions between a chord and the next one. The tables are enumerated once per
+ * pair of chord signatures and stored in the TransitionTableCache.
+ * @param pos the position of the first chord in the progression
+ * @return the legal transitions, marked as too large if the table has more than MAX_TRANSITION_TUPLES tuples
+ */
+const TransitionTable& VoicingRules::transition_table(int pos) const {
+    return TransitionTableCache::get(transition_signature(pos), [this, pos](){ return enumerate_transitions(pos); });
+}
+
+/**
+ * Returns whether the bass rises by step and the soprano falls by step between two chords
+ * @param current the voicing of the first chord
+ * @param next the voicing of the second chord
+ * @return true if the outer voices move by step in contrary motion, the bass going up
+ */
+bool VoicingRules::outer_voices_contrary_step(const vector<int> &current, const vector<int> &next) const {
+    int bassInterval = next[BASS] - current[BASS];
+    int sopranoInterval = next[SOPRANO] - current[SOPRANO];
+    return bassInterval > 0 && bassInterval <= MAJOR_SECOND && sopranoInterval < 0 && sopranoInterval >= -MAJOR_SECOND;
+}
+
+/**
+ * Returns the part of the cost vector that depends on a single chord
+ * @param pos the position of the chord in the progression
+ * @param voicing a chord in the form [bass, tenor, alto, soprano]
+ * @return the cost vector of the chord in lexicographical order
+ */
+VoicingRules::LexCost VoicingRules::voicing_cost(int pos, const vector<int> &voicing) const {
+    LexCost cost{};
+    int nOfValues = n_of_different_values(voicing, 0);
+    /// incomplete chord
+    cost[INCOMPLETE_CHORDS_COST] = n_of_different_values(voicing, PERFECT_OCTAVE) != nOfNotesInChord[pos];
+    /// diminished chord in fundamental state with 4 notes
+    cost[DIMINISHED_CHORDS_WITH_4_NOTES_COST] = isFundStateDiminished[pos] && nOfValues == 4;
+    /// chord with less than 4 note values
+    cost[CHORDS_WITH_LESS_THAN_4_VALUES_COST] = nOfValues < 4;
+    return cost;
+}
+
+/**
+ * Returns the part of the cost vector that depends on the melodic intervals between two chords
+ * @param current the voicing of the first chord
+ * @param next the voicing of the second chord
+ * @return the cost vector of the transition in lexicographical order
+ */
+VoicingRules::LexCost VoicingRules::transition_cost(const vector<int> &current, const vector<int> &next) const {
+    LexCost cost{};
+    for(int voice = BASS; voice <= SOPRANO; voice++){
+        int interval = next[voice] - current[voice];
+        /// weighted sum of melodic intervals
+        cost[MELODIC_INTERVALS_COST] += MELODIC_INTERVAL_COSTS[interval + PERFECT_OCTAVE];
+        /// common notes in the same voice (maximized so negative)
+        if(interval == UNISSON)
+            cost[COMMON_NOTES_COST]--;
+    }
+    return cost;
+}
+
+/**
+ * Finds an optimal voicing for the whole progression by dynamic programming. The states of the Viterbi pass are
+ * the legal voicings of each chord, together with whether the outer voices moved by step in contrary motion into
+ * that chord when its doubling depends on it.
+ * @param costs filled with the cost vector of the optimal solution in lexicographical order
+ * @return the notes of all the chords in the form [bass0, tenor0, alto0, soprano0, bass1, ...], or an empty vector
+ * if the problem has no solution
+ */
+vector<int> VoicingRules::optimal_voicing(vector<int> &costs) const {
+    costs.clear();
+    if(size <= 0)
+        return {};
+
+    vector<vector<vector<int>>> voicings(size);
+    for(int i = 0; i < size; i++){
+        voicings[i] = legal_voicings(i);
+        if(voicings[i].empty())
+            return {};
+    }
+
+    /// state 2*v + step: voicing v, step is true if the outer voices moved by step in contrary motion into the chord
+    vector<vector<LexCost>> bestCosts(size);
+    vector<vector<int>> previousStates(size);
+    vector<vector<bool>> reached(size);
+    for(int i = 0; i < size; i++){
+        bestCosts[i] = vector<LexCost>(2 * voicings[i].size());
+        previousStates[i] = vector<int>(2 * voicings[i].size(), -1);
+        reached[i] = vector<bool>(2 * voicings[i].size(), false);
+    }
+    for(int v = 0; v < (int) voicings[0].size(); v++){
+        bestCosts[0][2 * v] = voicing_cost(0, voicings[0][v]);
+        reached[0][2 * v] = true;
+    }
+
+    for(int i = 0; i < size - 1; i++){
+        vector<LexCost> nextCosts;
+        nextCosts.reserve(voicings[i + 1].size());
+        for(const auto &voicing : voicings[i + 1])
+            nextCosts.push_back(voicing_cost(i + 1, voicing));
+
+        for(int state = 0; state < (int) bestCosts[i].size(); state++){
+            if(!reached[i][state])
+                continue;
+            const vector<int> &current = voicings[i][state / 2];
+            bool stepIn = state % 2 == 1;
+            int nOfThirds = n_of_thirds(i, current);
+            for(int w = 0; w < (int) voicings[i + 1].size(); w++){
+                const vector<int> &next = voicings[i + 1][w];
+                if(!is_legal_transition(i, current, next))
+                    continue;
+                bool stepOut = outer_voices_contrary_step(current, next);
+                /// the third is doubled if and only if the outer voices move by step in contrary motion around the chord
+                if(depends_on_contrary_motion(i) && (nOfThirds == 2) != (stepIn && stepOut))
+                    continue;
+                int nextState = 2 * w + (depends_on_contrary_motion(i + 1) && stepOut ? 1 : 0);
+                LexCost cost = add_costs(add_costs(bestCosts[i][state], transition_cost(current, next)), nextCosts[w]);
+                if(!reached[i + 1][nextState] || cost < bestCosts[i + 1][nextState]){
+                    bestCosts[i + 1][nextState] = cost;
+                    previousStates[i + 1][nextState] = state;
+                    reached[i + 1][nextState] = true;
+                }
+            }
+        }
+    }
+
+    /// best final state
+    int bestState = -1;
+    for(int state = 0; state < (int) bestCosts[size - 1].size(); state++){
+        if(reached[size - 1][state] && (bestState == -1 || bestCosts[size - 1][state] < bestCosts[size - 1][bestState]))
+            bestState = state;
+    }
+    if(bestState == -1)
+        return {};
+
+    costs = vector<int>(bestCosts[size - 1][bestState].begin(), bestCosts[size - 1][bestState].end());
+    vector<int> solution(nOfVoices * size);
+    for(int i = size - 1, state = bestState; i >= 0; state = previousStates[i][state], i--){
+        const vector<int> &voicing = voicings[i][state / 2];
+        for(int voice = BASS; voice <= SOPRANO; voice++)
+            solution[nOfVoices * i + voice] = voicing[voice];
+    }
+    return solution;
+}
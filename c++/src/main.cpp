@@ -48,24 +48,15 @@ int main(int argc, char* argv[]) {
 
     /// Solve the problem
     vector<FourVoiceTexture*> sols;
-    /// Find the best solution
-    FourVoiceTexture* bestSol = solve_diatony_problem_optimal(size, tonality, chords, chords_qualities, states);
-
     if(search_type == "all"){ /// We want to generate all solutions that are close to optimal
-        auto best_sol_costs = bestSol->get_cost_vector();
-        vector<int> costs;
-        costs.reserve(best_sol_costs.size());
-        for(const auto& c : best_sol_costs){
-            costs.push_back(c.val());
-        }
-        ///find all optimal solutions (with or without margin)
-        auto all_sols = find_optimal_solutions_with_margin(size, tonality, chords, chords_qualities, states, costs, 0.1);
-        for(auto sol : all_sols){
-            sols.push_back(sol);
-        }
+        /// the best solution and the solutions close to it are collected in a single search
+        sols = solve_diatony_problem_near_optimal(size, tonality, chords, chords_qualities, states, 0.1, 100, true);
     }
     else{
-        sols.push_back(bestSol);
+        /// Find the best solution
+        FourVoiceTexture* bestSol = solve_diatony_problem_optimal(size, tonality, chords, chords_qualities, states);
+        if(bestSol != nullptr)
+            sols.push_back(bestSol);
     }
 
     if(build_midi == "true" && !sols.empty()){
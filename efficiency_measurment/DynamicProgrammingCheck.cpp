@@ -0,0 +1,69 @@
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/**
+ * Solves a test case with the constraint model and the search of solve_diatony_problem
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param complete set to true if the search was complete
+ * @return the cost vector of the best solution found, or an empty vector if there is none
+ */
+vector<int> run_gecode(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities, bool* complete){
+    vector<int> best;
+    SolutionCallback keep_costs = [&best](FourVoiceTexture &solution, const vector<int> &costs){
+        best = costs;
+        return true;
+    };
+    solve_diatony_problem_stream(testCase[0].size(), tonality, testCase[0], qualities, testCase[3], keep_costs, false,
+                                 60000, complete);
+    return best;
+}
+
+/**
+ * Solves a test case by dynamic programming. The solution is assigned in the constraint model, which computes its costs
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @return the cost vector of the optimal solution, or an empty vector if there is none or if the model rejects it
+ */
+vector<int> run_dp(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities){
+    FourVoiceTexture* sol = solve_diatony_problem_dp(testCase[0].size(), tonality, testCase[0], qualities, testCase[3]);
+    if(sol == nullptr)
+        return {};
+    vector<int> costs = intVarArgs_to_int_vector(sol->get_cost_vector());
+    delete sol;
+    return costs;
+}
+
+/**
+ * Checks that the dynamic programming engine finds the same lexicographic optimum as the search on the constraint
+ * model, on the test cases in all the tonalities of the benchmark. When the search is stopped by the time limit, the
+ * optimum of the dynamic programming must be at least as good as the best solution it found. The results are printed
+ * in CSV format, and the program returns 1 if one of the test cases gives different costs.
+ */
+int main(int argc, char* argv[]) {
+    int nOfMismatches = 0;
+    cout << "Chord progression, Tonality, Gecode cost vector, Gecode search complete, Dynamic programming cost vector, "
+            "Same" << endl;
+    for_each_test_case([&nOfMismatches](int i, Tonality* tonality, vector<int> &qualities){
+        bool complete = false;
+        vector<int> gecode = run_gecode(tonality, testCases[i], qualities, &complete);
+        vector<int> dp = run_dp(tonality, testCases[i], qualities);
+        /// the dynamic programming engine is exact, so it can only beat a search that did not complete
+        bool same = complete ? dp == gecode : (!dp.empty() && (gecode.empty() || dp <= gecode));
+        if(!same)
+            nOfMismatches++;
+        cout << testCasesNames[i] << "," << tonality->get_name() << "," << int_vector_to_string(gecode) << ","
+             << (complete ? "yes" : "no") << "," << int_vector_to_string(dp) << "," << (same ? "yes" : "no") << endl;
+    });
+    return nOfMismatches == 0 ? 0 : 1;
+}
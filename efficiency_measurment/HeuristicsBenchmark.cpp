@@ -0,0 +1,65 @@
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/** The decay factors tried for the AFC and action heuristics */
+const vector<double> decays = {1.0, 0.99, 0.95};
+
+/**
+ * Solves a test case to optimality with the search of solve_diatony_problem and a given variable selection
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param options the options of the model, with the variable selection heuristic to use
+ * @return a CSV string containing the time taken to find the first and the best solutions, whether optimality was
+ * proven, the cost vector of the best solution and the statistics of the search
+ */
+string run_heuristic(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities,
+                     const FourVoiceTextureOptions &options){
+    int size = testCase[0].size();
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], options);
+    SearchResults results = search_to_optimality(pb, size, start);
+
+    return to_string(results.firstSolutionTime) + "," + to_string(results.totalTime) + "," +
+           (results.optimal ? "yes" : "no") + "," + results.costs + "," + statistics_to_csv_string(results.statistics);
+}
+
+/**
+ * Compares the variable selection heuristics on the test cases in all the tonalities of the benchmark: the static
+ * orders, and the AFC and action heuristics with several decay factors as well as CHB, which learn from the failures
+ * of the search and keep what they learnt across restarts. The results are printed in CSV format.
+ */
+int main(int argc, char* argv[]) {
+    /// the heuristics to compare with their decay factor
+    vector<pair<int, double>> heuristics;
+    for(int h = 0; h < N_OF_VARIABLE_SELECTIONS; h++){
+        if(h == AFC_MAX || h == ACTION_MAX)
+            for(double decay : decays)
+                heuristics.emplace_back(h, decay);
+        else
+            heuristics.emplace_back(h, 1.0);
+    }
+
+    cout << "Chord progression, Tonality, Variable selection, Decay, First solution time, Total time, Optimal, "
+            "Cost vector, Nodes traversed, Failed nodes explored, Restarts performed, Propagators executed, "
+            "No goods generated, Maximal depth of explored tree" << endl;
+    for_each_test_case([&heuristics](int i, Tonality* tonality, vector<int> &qualities){
+        for(const auto &heuristic : heuristics){
+            FourVoiceTextureOptions options;
+            options.variableSelection = heuristic.first;
+            options.decay = heuristic.second;
+            cout << testCasesNames[i] << "," << tonality->get_name() << ","
+                 << variable_selection_heuristics_names[heuristic.first] << "," << heuristic.second << ","
+                 << run_heuristic(tonality, testCases[i], qualities, options) << endl;
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/** The number of copies of a space over which the time of a copy is averaged */
+const int N_OF_CLONES = 1000;
+/** The number of models built for each test case, over which the construction time is averaged */
+const int N_OF_CONSTRUCTIONS = 200;
+
+/**
+ * Builds and solves a test case to optimality with the search of solve_diatony_problem
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param options the options of the model
+ * @param costs filled with the cost vector of the best solution found
+ * @return a CSV string containing the size of the model after the initial propagation, the time taken to copy it, the
+ * average time taken to build it with and without the initial propagation, the number and size of the transition
+ * tables it enumerated and the time taken to do so, the time taken to solve it and the statistics of the search
+ */
+string run_model(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities,
+                 const FourVoiceTextureOptions &options, string &costs){
+    int size = testCase[0].size();
+    /// for small problems, building the model is a noticeable share of the total time, so it is averaged over several
+    /// builds, with and without the initial propagation. The transition tables are only enumerated by the first build
+    /// that needs them, so the tables added to the cache by those builds are reported separately
+    TransitionTableStatistics tablesBefore = TransitionTableCache::get_statistics();
+    std::chrono::duration<double, std::micro> constructionTime(0), propagationTime(0);
+    for(int c = 0; c < N_OF_CONSTRUCTIONS; c++){
+        auto constructionStart = std::chrono::high_resolution_clock::now();
+        auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], options);
+        auto constructed = std::chrono::high_resolution_clock::now();
+        pb->status();
+        auto propagated = std::chrono::high_resolution_clock::now();
+        constructionTime += constructed - constructionStart;
+        propagationTime += propagated - constructionStart;
+        delete pb;
+    }
+    TransitionTableStatistics tablesAfter = TransitionTableCache::get_statistics();
+
+    /// the search copies the space at every restart and for recomputation, so the time of a copy is measured too
+    auto model = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], options);
+    model->status();
+    int nOfPropagators = model->propagators();
+    size_t memory = model->allocated();
+    auto cloneStart = std::chrono::high_resolution_clock::now();
+    for(int c = 0; c < N_OF_CLONES; c++)
+        delete model->clone();
+    std::chrono::duration<double, std::micro> cloneTime =
+            (std::chrono::high_resolution_clock::now() - cloneStart) / N_OF_CLONES;
+    delete model;
+
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], options);
+    SearchResults results = search_to_optimality(pb, size, start);
+    costs = results.costs;
+
+    return to_string(nOfPropagators) + "," + to_string(memory) + "," + to_string(cloneTime.count()) + "," +
+           to_string(constructionTime.count() / N_OF_CONSTRUCTIONS) + "," +
+           to_string(propagationTime.count() / N_OF_CONSTRUCTIONS) + "," +
+           to_string(tablesAfter.nOfTables - tablesBefore.nOfTables) + "," +
+           to_string(tablesAfter.nOfTuples - tablesBefore.nOfTuples) + "," +
+           to_string(tablesAfter.nOfTooLarge - tablesBefore.nOfTooLarge) + "," +
+           to_string(tablesAfter.enumerationTime - tablesBefore.enumerationTime) + "," +
+           to_string(results.totalTime) + "," +
+           (results.optimal ? "yes" : "no") + "," + costs + "," + statistics_to_csv_string(results.statistics);
+}
+
+/**
+ * Compares several versions of the model on the test cases in all the tonalities of the benchmark. For each model, it
+ * reports the number of propagators, the memory and the time of a copy of a space after the initial propagation, the
+ * average construction time, the solving time, and the statistics of the search. Running it before and after a change
+ * to the construction of the model shows its effect. The results are printed in CSV format.
+ */
+int main(int argc, char* argv[]) {
+    /// the models compared:
+    /// - reified: parallel intervals forbidden with reified constraints, chord content with nvalues and count
+    /// - propagator: reified, with parallel intervals forbidden by the ParallelIntervals propagator
+    /// - propagators: propagator, with the MelodicCostBound and ChordContent propagators
+    /// - propagators with decomposed chord content: propagators, with the chord content with nvalues and count
+    /// - transition tables: propagators, with the rules between chords posted as tables of legal transitions
+    /// - voicing indices: propagators, branching on the index of the voicing of each chord instead of on its notes
+    /// - closest neighbour values: propagators, trying first the notes closest to the neighbouring chords
+    const vector<string> modelNames = {"reified", "propagator", "propagators",
+                                       "propagators with decomposed chord content", "transition tables",
+                                       "voicing indices", "closest neighbour values"};
+    cout << "Chord progression, Tonality, Model, Propagators, Memory per space (bytes), Copy time (us), "
+            "Construction time (us), Construction and initial propagation time (us), Transition tables enumerated, "
+            "Tuples enumerated, Transition tables too large, Enumeration time (ms), Total time, Optimal, "
+            "Cost vector, Nodes traversed, Failed nodes explored, Restarts performed, Propagators executed, "
+            "No goods generated, Maximal depth of explored tree" << endl;
+    for_each_test_case([&modelNames](int i, Tonality* tonality, vector<int> &qualities){
+        vector<string> costs(modelNames.size());
+        for(int m = 0; m < modelNames.size(); m++){
+            FourVoiceTextureOptions options;
+            options.decomposedParallels = m == 0;
+            options.melodicCostBound = m >= 2;
+            options.decomposedChordContent = m <= 1 || m == 3;
+            options.transitionTables = m == 4;
+            options.voicingIndices = m == 5;
+            if(m == 6)
+                options.valueSelection = VAL_CLOSEST_NEIGHBOUR;
+            string results = run_model(tonality, testCases[i], qualities, options, costs[m]);
+            cout << testCasesNames[i] << "," << tonality->get_name() << "," << modelNames[m] << "," << results << endl;
+        }
+        for(int m = 1; m < modelNames.size(); m++)
+            if(costs[m] != costs[0])
+                cerr << "The models " << modelNames[0] << " and " << modelNames[m] << " found different costs for "
+                     << testCasesNames[i] << " in " << tonality->get_name() << ": " << costs[0] << " and " << costs[m]
+                     << endl;
+    });
+    return 0;
+}
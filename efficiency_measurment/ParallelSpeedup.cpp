@@ -0,0 +1,80 @@
+#include <thread>
+
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/**
+ * Solves a test case with the parallel engine
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param nOfThreads the number of threads
+ * @param deterministic true to use the deterministic mode
+ * @param time filled with the time taken in seconds
+ * @return a CSV string containing the cost vector of the solution found and the statistics of the search
+ */
+string run_parallel(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities, int nOfThreads,
+                    bool deterministic, double &time){
+    Search::Statistics stats;
+    auto start = std::chrono::high_resolution_clock::now();     /// start time
+    FourVoiceTexture* sol = solve_diatony_problem_parallel(testCase[0].size(), tonality, testCase[0], qualities,
+                                                           testCase[3], nOfThreads, deterministic, false, &stats);
+    auto currTime = std::chrono::high_resolution_clock::now();     /// current time
+    std::chrono::duration<double> duration = currTime - start;
+    time = duration.count();
+
+    string results = (sol == nullptr ? "no solution" : intVarArgs_to_string(sol->get_cost_vector())) + ",";
+    results += statistics_to_csv_string(stats);
+    delete sol;
+    return results;
+}
+
+/**
+ * Measures the speedup of the parallel engine on the test cases, in all the tonalities of the benchmark. Each problem
+ * is solved with 1, 2, 4, ... threads up to the number of hardware threads (or the number given as argument), in both
+ * modes. The deterministic mode is run twice to check that it returns the same cost vector and the same statistics.
+ * The results are printed in CSV format.
+ */
+int main(int argc, char* argv[]) {
+    int maxThreads = max(1, (int) std::thread::hardware_concurrency());
+    if(argc > 1)
+        maxThreads = stoi(argv[1]);
+
+    vector<int> nOfThreads;
+    for(int t = 1; t < maxThreads; t *= 2)
+        nOfThreads.push_back(t);
+    nOfThreads.push_back(maxThreads);
+
+    cout << "Chord progression, Tonality, Mode, Threads, Time, Speedup, Cost vector, Nodes traversed, "
+            "Failed nodes explored, Restarts performed, Propagators executed, No goods generated, "
+            "Maximal depth of explored tree" << endl;
+    for_each_test_case([&nOfThreads](int i, Tonality* tonality, vector<int> &qualities){
+        for(bool deterministic : {false, true}){
+            double sequentialTime = 0;
+            for(auto threads : nOfThreads){
+                double time;
+                string results = run_parallel(tonality, testCases[i], qualities, threads, deterministic, time);
+                if(threads == 1)
+                    sequentialTime = time;
+                cout << testCasesNames[i] << "," << tonality->get_name() << ","
+                     << (deterministic ? "deterministic" : "default") << "," << threads << "," << time << ","
+                     << sequentialTime / time << "," << results << endl;
+                if(deterministic){ /// a second run must give the same results
+                    double timeAgain;
+                    if(run_parallel(tonality, testCases[i], qualities, threads, deterministic, timeAgain) != results)
+                        cerr << "The deterministic mode gave different results for " << testCasesNames[i] << " in "
+                             << tonality->get_name() << " with " << threads << " threads" << endl;
+                }
+            }
+        }
+    });
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <thread>
+
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/** The time after which the search is paused, in milliseconds */
+const int PAUSE_AFTER = 50;
+/** The time during which the search stays paused, in milliseconds */
+const int PAUSE_DURATION = 200;
+
+/**
+ * Solves a test case to optimality, pausing and resuming the search from another thread if a token is given
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param token if not nullptr, the token of the search, paused after PAUSE_AFTER ms for PAUSE_DURATION ms
+ * @param complete set to true if the search was complete
+ * @return the cost vector of the best solution found, or an empty vector if there is none
+ */
+vector<int> run_search(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities,
+                       CancellationToken* token, bool* complete){
+    vector<int> best;
+    SolutionCallback keep_costs = [&best](FourVoiceTexture &solution, const vector<int> &costs){
+        best = costs;
+        return true;
+    };
+    std::thread search([&](){
+        solve_diatony_problem_stream(testCase[0].size(), tonality, testCase[0], qualities, testCase[3], keep_costs,
+                                     false, 60000, complete, FourVoiceTextureOptions(), token);
+    });
+    if(token != nullptr){
+        std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_AFTER));
+        token->pause();
+        std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_DURATION));
+        token->resume();
+    }
+    search.join();
+    return best;
+}
+
+/**
+ * Checks that pausing and resuming a search does not end it: on the test cases in all the tonalities of the benchmark,
+ * a search paused and resumed must reach the same optimum as an uninterrupted one. The results are printed in CSV
+ * format, and the program returns 1 if one of the test cases gives different costs.
+ */
+int main(int argc, char* argv[]) {
+    int nOfMismatches = 0;
+    cout << "Chord progression, Tonality, Uninterrupted cost vector, Paused cost vector, Paused search complete, Same"
+         << endl;
+    for_each_test_case([&nOfMismatches](int i, Tonality* tonality, vector<int> &qualities){
+        bool uninterruptedComplete = false, pausedComplete = false;
+        vector<int> uninterrupted = run_search(tonality, testCases[i], qualities, nullptr, &uninterruptedComplete);
+        CancellationToken token;
+        vector<int> paused = run_search(tonality, testCases[i], qualities, &token, &pausedComplete);
+        /// only optimal costs can be compared: a search stopped by the time limit depends on the speed of the run
+        bool same = !uninterruptedComplete || (pausedComplete && paused == uninterrupted);
+        if(!same)
+            nOfMismatches++;
+        cout << testCasesNames[i] << "," << tonality->get_name() << "," << int_vector_to_string(uninterrupted) << ","
+             << int_vector_to_string(paused) << "," << (pausedComplete ? "yes" : "no") << "," << (same ? "yes" : "no")
+             << endl;
+    });
+    return nOfMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include "../c++/headers/diatony/FourVoiceTexture.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+#include <chrono>
+
+using namespace Gecode;
+using namespace std;
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ * This benchmark is compiled against older versions of the sources by compare_revisions.sh, so it only uses what      *
+ * every version provides: the test cases, the constructor of FourVoiceTexture without options and the Gecode API.     *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+
+/** The number of copies of a space over which the time of a copy is averaged */
+const int N_OF_CLONES = 1000;
+/** The number of models built for each test case, over which the construction time is averaged */
+const int N_OF_CONSTRUCTIONS = 200;
+
+/**
+ * Builds and solves a test case with the default model of the version it is compiled with
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @return a CSV string containing the number of propagators and the memory of a space after the initial propagation,
+ * the time of a copy, the average time taken to build the model with and without the initial propagation, the time
+ * taken to solve it and the statistics of the search
+ */
+string run(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities){
+    int size = testCase[0].size();
+    std::chrono::duration<double, std::micro> constructionTime(0), propagationTime(0);
+    for(int c = 0; c < N_OF_CONSTRUCTIONS; c++){
+        auto constructionStart = std::chrono::high_resolution_clock::now();
+        auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3]);
+        auto constructed = std::chrono::high_resolution_clock::now();
+        pb->status();
+        auto propagated = std::chrono::high_resolution_clock::now();
+        constructionTime += constructed - constructionStart;
+        propagationTime += propagated - constructionStart;
+        delete pb;
+    }
+
+    auto model = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3]);
+    model->status();
+    int nOfPropagators = model->propagators();
+    size_t memory = model->allocated();
+    auto cloneStart = std::chrono::high_resolution_clock::now();
+    for(int c = 0; c < N_OF_CLONES; c++)
+        delete model->clone();
+    std::chrono::duration<double, std::micro> cloneTime =
+            (std::chrono::high_resolution_clock::now() - cloneStart) / N_OF_CLONES;
+    delete model;
+
+    /// the same search as solve_diatony_problem. The cutoff is written out because older versions do not share it
+    int nOfNotes = 4 * size;
+    Search::TimeStop stop(60000);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    opts.cutoff = Search::Cutoff::merge(Search::Cutoff::linear(2*size),
+                                        Search::Cutoff::geometric(nOfNotes * nOfNotes, 2));
+    opts.nogoods_limit = size * 4 * 4;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3]);
+    RBS<FourVoiceTexture, BAB> solver(pb, opts);
+    delete pb;
+    string costs = "no solution";
+    while(FourVoiceTexture* sol = solver.next()){
+        costs = intVarArgs_to_string(sol->get_cost_vector());
+        delete sol;
+    }
+    std::chrono::duration<double> totalTime = std::chrono::high_resolution_clock::now() - start;
+
+    return to_string(nOfPropagators) + "," + to_string(memory) + "," + to_string(cloneTime.count()) + "," +
+           to_string(constructionTime.count() / N_OF_CONSTRUCTIONS) + "," +
+           to_string(propagationTime.count() / N_OF_CONSTRUCTIONS) + "," + to_string(totalTime.count()) + "," +
+           (solver.stopped() ? "no" : "yes") + "," + costs + "," + statistics_to_csv_string(solver.statistics());
+}
+
+/**
+ * Measures the default model on the test cases in all the tonalities of the benchmark: the number of propagators, the
+ * memory and the time of a copy of a space, the construction time, the solving time and the statistics of the search.
+ * The results are printed in CSV format, each line starting with the label given as argument, for example the
+ * version of the sources.
+ */
+int main(int argc, char* argv[]) {
+    string label = argc > 1 ? argv[1] : "current";
+    cout << "Version, Chord progression, Tonality, Propagators, Memory per space (bytes), Copy time (us), "
+            "Construction time (us), Construction and initial propagation time (us), Total time, Optimal, "
+            "Cost vector, Nodes traversed, Failed nodes explored, Restarts performed, Propagators executed, "
+            "No goods generated, Maximal depth of explored tree" << endl;
+    for(int i = 0; i < testCases.size(); i++){
+        for(int t = 0; t < tonics.size(); t++){
+            Tonality* tonality;
+            if(modes[t] == MAJOR_MODE)
+                tonality = new MajorTonality(tonics[t]);
+            else
+                tonality = new MinorTonality(tonics[t]);
+            vector<int> qualities = modes[t] == MAJOR_MODE ? testCases[i][1] : testCases[i][2];
+            cout << label << "," << testCasesNames[i] << "," << tonality->get_name() << ","
+                 << run(tonality, testCases[i], qualities) << endl;
+            delete tonality;
+        }
+    }
+    return 0;
+}
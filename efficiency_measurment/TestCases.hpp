@@ -2,7 +2,14 @@
  * This file contains the different test cases used to validate our model and assess its efficiency
 */
 
+#include <chrono>
+#include <functional>
+
 #include "../c++//headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+#include "../c++/headers/diatony/FourVoiceTexture.hpp"
+#include "../c++/headers/diatony/SolveDiatony.hpp"
 
 /***********************************************************************************************************************
  *                                                                                                                     *
@@ -133,4 +140,75 @@ vector<vector<int>> testCase7 = {chords7, chords_qualities_major7, chords_qualit
 
 vector<vector<vector<int>>> testCases = {testCase1, testCase2, testCase3, testCase4, testCase5, testCase6};
 
-vector<string> testCasesNames = {testCase1Name, testCase2Name, testCase3Name, testCase4Name, testCase5Name, testCase6Name};
\ No newline at end of file
+vector<string> testCasesNames = {testCase1Name, testCase2Name, testCase3Name, testCase4Name, testCase5Name, testCase6Name};
+
+
+/***********************************************************************************************************************
+ *                                                                                                                     *
+ *                                                 Benchmark helpers                                                   *
+ *                                                                                                                     *
+ ***********************************************************************************************************************/
+
+/**
+ * Calls a function on each test case in each tonality of the benchmark. The tonality is deleted once the function
+ * returns.
+ * @param run called with the index of the test case, the tonality, and the qualities of the chords in that tonality
+ */
+void for_each_test_case(const function<void(int testCase, Tonality* tonality, vector<int> &qualities)> &run){
+    for(int i = 0; i < testCases.size(); i++){
+        for(int t = 0; t < tonics.size(); t++){
+            Tonality* tonality;
+            if(modes[t] == MAJOR_MODE)
+                tonality = new MajorTonality(tonics[t]);
+            else
+                tonality = new MinorTonality(tonics[t]);
+            vector<int> qualities = modes[t] == MAJOR_MODE ? testCases[i][1] : testCases[i][2];
+            run(i, tonality, qualities);
+            delete tonality;
+        }
+    }
+}
+
+/**
+ * The results of the search of a test case to optimality
+ */
+struct SearchResults {
+    double                      firstSolutionTime = -1;                     // seconds until the first solution, -1 if none
+    double                      totalTime = 0;                              // seconds until the end of the search
+    bool                        optimal = false;                            // true if the search was not stopped
+    string                      costs = "no solution";                      // the cost vector of the best solution
+    Search::Statistics          statistics;                                 // the statistics of the search
+};
+
+/**
+ * Solves a problem to optimality with the restart based branch and bound search of solve_diatony_problem
+ * @param pb the problem, deleted by this function
+ * @param size the number of chords of the problem
+ * @param start the time from which the times of the results are measured, for example before building the problem
+ * @param timeLimit the time limit of the search in milliseconds
+ * @return the results of the search
+ */
+SearchResults search_to_optimality(FourVoiceTexture* pb, int size, std::chrono::high_resolution_clock::time_point start,
+                                   double timeLimit = 60000){
+    Search::TimeStop stop(timeLimit);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    opts.cutoff = restart_cutoff(size);
+    opts.nogoods_limit = size * 4 * 4;
+    RBS<FourVoiceTexture, BAB> solver(pb, opts);
+    delete pb;
+
+    SearchResults results;
+    while(FourVoiceTexture* sol = solver.next()){
+        if(results.firstSolutionTime < 0)
+            results.firstSolutionTime =
+                    std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        results.costs = intVarArgs_to_string(sol->get_cost_vector());
+        delete sol;
+    }
+    results.totalTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    results.optimal = !solver.stopped();
+    results.statistics = solver.statistics();
+    return results;
+}
@@ -0,0 +1,107 @@
+#include "../c++/headers/diatony/SolveDiatony.hpp"
+#include "../c++/headers/aux/Utilities.hpp"
+#include "../c++/headers/aux/Tonality.hpp"
+#include "../c++/headers/aux/MajorTonality.hpp"
+#include "../c++/headers/aux/MinorTonality.hpp"
+
+#include "TestCases.hpp"
+
+using namespace Gecode;
+using namespace std;
+
+/** The number of solutions of each model checked against the other model for each test case */
+const int N_OF_SOLUTIONS = 1000;
+
+/**
+ * Enumerates solutions of a test case with one model and checks that the other model accepts them. Once all the notes
+ * are assigned, the propagation of a model decides whether its rules hold, so a solution is rejected if and only if it
+ * breaks one of them.
+ * @param tonality the tonality of the test case
+ * @param testCase the test case
+ * @param qualities the qualities of the chords in that tonality
+ * @param from the options of the model whose solutions are enumerated
+ * @param to the options of the model that checks them
+ * @param nOfSolutions set to the number of solutions checked, at most N_OF_SOLUTIONS
+ * @return the number of solutions rejected by the other model
+ */
+int count_rejected(Tonality* tonality, vector<vector<int>> &testCase, vector<int> &qualities,
+                   const FourVoiceTextureOptions &from, const FourVoiceTextureOptions &to, int* nOfSolutions){
+    int size = testCase[0].size();
+    auto checker = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], to);
+    checker->status();
+
+    auto pb = new FourVoiceTexture(size, tonality, testCase[0], qualities, testCase[3], from);
+    Search::TimeStop stop(60000);
+    Search::Options opts;
+    opts.threads = 1;
+    opts.stop = &stop;
+    DFS<FourVoiceTexture> solver(pb, opts);
+    delete pb;
+
+    int rejected = 0;
+    *nOfSolutions = 0;
+    while(*nOfSolutions < N_OF_SOLUTIONS){
+        FourVoiceTexture* sol = solver.next();
+        if(sol == nullptr)
+            break;
+        (*nOfSolutions)++;
+        auto check = (FourVoiceTexture*) checker->clone();
+        check->fix_voicing(intVarArray_to_int_vector(sol->getFullVoicing()));
+        if(check->status() == SS_FAILED)
+            rejected++;
+        delete check;
+        delete sol;
+    }
+    delete checker;
+    return rejected;
+}
+
+/**
+ * Checks that the tables of legal transitions between chords accept the same voicings as the propagators they replace,
+ * on the test cases in all the tonalities of the benchmark. Solutions of each model are checked against the other one,
+ * and both models are solved to optimality, which must give the same cost vector. The number of nodes and failed nodes
+ * of both searches are reported. The results are printed in CSV format, and the program returns 1 if one of the test
+ * cases shows a difference between the models.
+ */
+int main(int argc, char* argv[]) {
+    FourVoiceTextureOptions propagators;
+    FourVoiceTextureOptions tables;
+    tables.transitionTables = true;
+
+    int nOfMismatches = 0;
+    cout << "Chord progression, Tonality, Propagator solutions checked, Rejected by the tables, Table solutions checked, "
+            "Rejected by the propagators, Propagators cost vector, Propagators optimal, Propagators nodes, "
+            "Propagators failed nodes, Tables cost vector, Tables optimal, Tables nodes, Tables failed nodes, Same"
+         << endl;
+    for_each_test_case([&](int i, Tonality* tonality, vector<int> &qualities){
+        int size = testCases[i][0].size();
+        int nOfPropagatorSolutions, nOfTableSolutions;
+        int rejectedByTables = count_rejected(tonality, testCases[i], qualities, propagators, tables,
+                                              &nOfPropagatorSolutions);
+        int rejectedByPropagators = count_rejected(tonality, testCases[i], qualities, tables, propagators,
+                                                   &nOfTableSolutions);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        SearchResults withPropagators = search_to_optimality(
+                new FourVoiceTexture(size, tonality, testCases[i][0], qualities, testCases[i][3], propagators),
+                size, start);
+        start = std::chrono::high_resolution_clock::now();
+        SearchResults withTables = search_to_optimality(
+                new FourVoiceTexture(size, tonality, testCases[i][0], qualities, testCases[i][3], tables),
+                size, start);
+
+        /// the costs can only be compared if both searches completed
+        bool same = rejectedByTables == 0 && rejectedByPropagators == 0 &&
+                    (!withPropagators.optimal || !withTables.optimal || withPropagators.costs == withTables.costs);
+        if(!same)
+            nOfMismatches++;
+        cout << testCasesNames[i] << "," << tonality->get_name() << "," << nOfPropagatorSolutions << ","
+             << rejectedByTables << "," << nOfTableSolutions << "," << rejectedByPropagators << ","
+             << withPropagators.costs << "," << (withPropagators.optimal ? "yes" : "no") << ","
+             << withPropagators.statistics.node << "," << withPropagators.statistics.fail << ","
+             << withTables.costs << "," << (withTables.optimal ? "yes" : "no") << ","
+             << withTables.statistics.node << "," << withTables.statistics.fail << "," << (same ? "yes" : "no")
+             << endl;
+    });
+    return nOfMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+# Compares the default model before and after a commit with SpaceBenchmark.cpp. The benchmark of the current tree is
+# compiled against the commit and its parent, each checked out in a temporary worktree.
+# Usage: ./compare_revisions.sh <commit> <output file>
+# The commit can be given by its message, for example ":/Intern the IntSets"
+after=$(git rev-parse --short "$1") || exit 1
+before=$(git rev-parse --short "$after^") || exit 1
+outFile="$2"
+
+benchmark="$(pwd)/SpaceBenchmark.cpp"
+rm -f "$outFile"
+for commit in "$before" "$after"; do
+    worktree=$(mktemp -d)
+    git worktree add --detach "$worktree" "$commit" > /dev/null || exit 1
+    cp "$benchmark" "$worktree/efficiency_measurment/"
+
+    # every version has its own list of source files, so they are all compiled
+    echo "Compiling the benchmark against $commit..."
+    (cd "$worktree/efficiency_measurment" && \
+     g++ -std=c++11 -pthread -F/Library/Frameworks -framework gecode -o spaceBenchmark \
+         ../c++/src/aux/*.cpp ../c++/src/diatony/*.cpp ../c++/src/midifile/*.cpp SpaceBenchmark.cpp) || exit 1
+
+    echo "Running the benchmark on $commit..."
+    if [ -f "$outFile" ]; then
+        "$worktree/efficiency_measurment/spaceBenchmark" "$commit" | tail -n +2 >> "$outFile"
+    else
+        "$worktree/efficiency_measurment/spaceBenchmark" "$commit" > "$outFile"
+    fi
+    git worktree remove --force "$worktree"
+done
+echo "Results written to $outFile"
@@ -5,16 +5,17 @@ inputFile="TestCases.txt"
 
 # auxiliary files
 PROBLEM_FILES="../c++/src/aux/Utilities.cpp ../c++/src/aux/Tonality.cpp ../c++/src/aux/MajorTonality.cpp \
-                ../c++/src/aux/MinorTonality.cpp ../c++/src/diatony/VoiceLeadingConstraints.cpp ../c++/src/diatony/HarmonicConstraints.cpp \
-                ../c++/src/diatony/GeneralConstraints.cpp ../c++/src/diatony/Preferences.cpp ../c++/src/diatony/FourVoiceTexture.cpp \
-                ../c++/src/aux/MidiFileGeneration.cpp parallelRun.cpp"
+                ../c++/src/aux/MinorTonality.cpp ../c++/src/diatony/VoiceLeadingConstraints.cpp ../c++/src/diatony/ParallelIntervals.cpp ../c++/src/diatony/MelodicCostBound.cpp ../c++/src/diatony/ChordContent.cpp ../c++/src/diatony/HarmonicConstraints.cpp \
+                ../c++/src/diatony/GeneralConstraints.cpp ../c++/src/diatony/Preferences.cpp ../c++/src/diatony/FourVoiceTexture.cpp ../c++/src/diatony/VoicingCache.cpp ../c++/src/diatony/TransitionTableCache.cpp ../c++/src/diatony/ProgressionCache.cpp ../c++/src/diatony/SolutionStore.cpp ../c++/src/diatony/VoicingRules.cpp \
+                ../c++/src/diatony/SolveDiatony.cpp \
+                ../c++/src/aux/MidiFileGeneration.cpp ../c++/src/aux/SharedSearch.cpp ../c++/src/aux/WorkStealingPool.cpp parallelRun.cpp"
 
 MIDI_FILES="../c++/src/midifile/Options.cpp ../c++/src/midifile/MidiMessage.cpp ../c++/src/midifile/MidiEvent.cpp ../c++/src/midifile/MidiEventList.cpp \
             ../c++/src/midifile/Binasc.cpp ../c++/src/midifile/MidiFile.cpp"
 
 # Compile C++ files
 echo "Compiling C++ files..."
-g++ -std=c++11 -F/Library/Frameworks -framework gecode -o "$cpp_executable" $PROBLEM_FILES $MIDI_FILES
+g++ -std=c++11 -pthread -F/Library/Frameworks -framework gecode -o "$cpp_executable" $PROBLEM_FILES $MIDI_FILES
 echo "compilation complete"
 echo "Initializing the output file"
 currentDate=$(date +%Y-%m-%d_%H-%M-%S);
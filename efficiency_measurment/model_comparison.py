@@ -0,0 +1,48 @@
+import sys
+import math
+
+# Compares two models of the output of ModelBenchmark on each test case: solving time, nodes, failed nodes and memory
+# per space, with the geometric mean of the ratios over the test cases that both models solved to optimality.
+# Usage: python3 model_comparison.py <model benchmark csv> <reference model> <compared model>
+
+if len(sys.argv) != 4:
+    print("Wrong number of arguments")
+    exit()
+
+filename = sys.argv[1]
+reference = sys.argv[2]
+compared = sys.argv[3]
+
+# the cost vector takes a variable number of columns, so the statistics of the search are read from the end of the
+# line, which ends with a comma
+results = {}
+with open(filename, 'r') as csvfile:
+    for line in csvfile.readlines()[1:]:
+        line_data = [elem.strip() for elem in line.split(',')]
+        results[(line_data[0], line_data[1], line_data[2])] = {
+            "memory": float(line_data[4]),
+            "time": float(line_data[12]),
+            "optimal": line_data[13] == "yes",
+            "nodes": float(line_data[-7]),
+            "failures": float(line_data[-6]),
+        }
+
+measures = ["time", "nodes", "failures", "memory"]
+log_ratios = {measure: [] for measure in measures}
+print("Chord progression, Tonality, " + ", ".join(reference + " " + m + ", " + compared + " " + m for m in measures))
+for (progression, tonality, model), ref in results.items():
+    if model != reference or (progression, tonality, compared) not in results:
+        continue
+    other = results[(progression, tonality, compared)]
+    print(progression + ", " + tonality + ", " + ", ".join(str(ref[m]) + ", " + str(other[m]) for m in measures))
+    # a search stopped by the time limit says nothing about the time to prove optimality
+    if ref["optimal"] and other["optimal"]:
+        for m in measures:
+            if ref[m] > 0 and other[m] > 0:
+                log_ratios[m].append(math.log(other[m] / ref[m]))
+
+for m in measures:
+    if log_ratios[m]:
+        print("Geometric mean of " + compared + " / " + reference + " for the " + m + ": " +
+              str(math.exp(sum(log_ratios[m]) / len(log_ratios[m]))) + " over " + str(len(log_ratios[m])) +
+              " test cases")
@@ -78,7 +78,7 @@ int main(int argc, char* argv[]) {
     /// Search options
     int nVariables = testCases[test_case_number][0].size() * 4;
 
-    Cutoff* geo = Search::Cutoff::geometric(nVariables^2, 2);
+    Cutoff* geo = Search::Cutoff::geometric(nVariables * nVariables, 2);
     Cutoff* lin = Search::Cutoff::linear(nVariables/2);
     Cutoff* lin_geo = Search::Cutoff::merge(lin, geo);
 